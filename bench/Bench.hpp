@@ -0,0 +1,100 @@
+#ifndef BINARY_DATA_PROCESSING_BENCH_HPP
+#define BINARY_DATA_PROCESSING_BENCH_HPP
+
+/**
+ * @file Bench.hpp
+ * @brief The benchmarks that make up binary_data_processing_bench.
+ * @copyright CES Public License
+ */
+
+#include <cstddef>
+#include <string>
+
+/*
+ * Array deserialization throughput: per-element reads against the bulk read, same and cross endian.
+ */
+void run_array_bench();
+
+/*
+ * Cost of a single value round-trip through the buffer backend: typeid dispatch against type_tag_v.
+ */
+void run_scalar_bench();
+
+/*
+ * Small-record throughput: a stream call per value against the batched RecordWriter/RecordReader.
+ */
+void run_record_bench();
+
+/*
+ * Size and decode speed of varint arrays against native LONG_ARRAY payloads.
+ */
+void run_varint_bench();
+
+/*
+ * Size and decode speed of the delta, delta-of-delta and XOR float encodings against native arrays.
+ */
+void run_series_bench();
+
+/*
+ * Size and decode speed of dictionary encoded string arrays, and an equality filter on strings against codes.
+ */
+void run_dictionary_bench();
+
+/*
+ * CRC32C rates, and writing and reading a checksummed frame against plain serialization.
+ */
+void run_checksum_bench();
+
+/*
+ * Range scans over a zoned array, skipping blocks by their zones, against deserializing and filtering the plain array.
+ */
+void run_zone_map_bench();
+
+/*
+ * Reading one field of a record array: a STRUCT per record against one column of the COLUMNS encoding.
+ */
+void run_column_bench();
+
+/*
+ * Ratio and speed of the block compression stage, with and without the byte shuffle.
+ */
+void run_compression_bench();
+
+/*
+ * Scaling of the parallel array encode/decode and of the block compression from 1 to every hardware thread.
+ */
+void run_parallel_bench();
+
+/*
+ * Writing and reading a file of arrays through the double buffered AsyncWriter and AsyncReader against file streams.
+ */
+void run_async_bench();
+
+/*
+ * Latency of passing a value between processes through a SharedRing against writing and reading a file.
+ */
+void run_shared_ring_bench();
+
+/*
+ * Allocations and latency per message, deserializing strings through the heap against an Arena.
+ */
+void run_arena_bench();
+
+/*
+ * The settings of the benchmark matrix, from the command line of binary_data_processing_bench.
+ */
+struct SuiteOptions {
+    std::size_t max_bytes = std::size_t{64} << 20; // the largest array measured, in bytes of elements.
+    double min_time = 0.2; // seconds per measurement.
+    std::string filter; // only the type names that contain it, e.g. DOUBLE.
+    std::string csv; // where the results are written as CSV, nothing when empty.
+    std::string json; // where the results are written as JSON, nothing when empty.
+};
+
+/*
+ * Every type flag written and read through the buffer and the stream backends, same and cross endian, at sizes from
+ * one element up to options.max_bytes: ns/op, MB/s and allocations per operation.
+ */
+void run_suite_bench(const SuiteOptions &options);
+
+#endif //BINARY_DATA_PROCESSING_BENCH_HPP
@@ -0,0 +1,99 @@
+/**
+ * @file arena_bench.cpp
+ * @brief Measures deserializing messages of strings through the heap against an Arena that is reset per message.
+ * @details A message is a STRING (the route) and a STRING_ARRAY of 64 header values, the strings are too long for
+ * the small string buffer. Every message is decoded into new objects, as a request handler does. The allocations
+ * are counted by a resource between the containers and the heap, std::vector<std::string> makes the same ones.
+ * @copyright CES Public License
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "../inc/Arena.hpp"
+#include "../inc/BinaryConverter.hpp"
+#include "Bench.hpp"
+
+namespace {
+    constexpr std::size_t messages = 20000;
+    constexpr std::size_t headers = 64;
+
+    /*
+     * Counts the allocations passed on to another resource.
+     */
+    class CountingResource : public std::pmr::memory_resource {
+        std::pmr::memory_resource *upstream;
+
+    public:
+        std::size_t allocations = 0;
+
+        explicit CountingResource(std::pmr::memory_resource *upstream) : upstream(upstream) {}
+
+    protected:
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+            ++allocations;
+            return upstream->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override { upstream->deallocate(p, bytes, alignment); }
+
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+    };
+
+    /*
+     * Decodes every message once with decode(bytes) and prints the mean and the 99th percentile latency.
+     */
+    template<typename F>
+    void measure(const char *name, const std::vector<CES::ByteBuffer> &encoded, const CountingResource &counter, F &&decode) {
+        std::vector<double> latencies;
+        latencies.reserve(encoded.size());
+        const std::size_t allocations = counter.allocations;
+        for (const CES::ByteBuffer &message: encoded) {
+            const auto start = std::chrono::steady_clock::now();
+            decode(message.span());
+            latencies.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+        }
+        double total = 0;
+        for (const double latency: latencies) total += latency;
+        std::sort(latencies.begin(), latencies.end());
+        std::printf("%-24s %12.1f %9.0f ns %9.0f ns\n", name, static_cast<double>(counter.allocations - allocations) / encoded.size(),
+                    total / encoded.size(), latencies[latencies.size() * 99 / 100]);
+    }
+}
+
+void run_arena_bench() {
+    std::vector<CES::ByteBuffer> encoded(messages);
+    for (std::size_t m = 0; m < messages; ++m) {
+        std::vector<std::string> values(headers);
+        for (std::size_t h = 0; h < headers; ++h) values[h] = "x-header-" + std::to_string(h) + ": value " + std::to_string(m * h);
+        CES::BinaryConverter::serialize("/api/v1/resources/" + std::to_string(m) + "/details", encoded[m]);
+        CES::BinaryConverter::serialize(values, encoded[m]);
+    }
+
+    std::printf("%zu messages of 1 STRING and a STRING_ARRAY of %zu\n", messages, headers);
+    std::printf("%-24s %12s %12s %12s\n", "allocation", "allocs/msg", "mean", "p99");
+
+    std::size_t checksum = 0;
+    CountingResource heap(std::pmr::new_delete_resource());
+    measure("heap", encoded, heap, [&](std::span<const std::byte> bytes) {
+        const std::size_t offset = CES::BinaryConverter::skip(bytes);
+        auto route = CES::BinaryConverter::deserialize<std::pmr::string>(bytes, &heap);
+        auto values = CES::BinaryConverter::deserialize<std::pmr::vector<std::pmr::string>>(bytes.subspan(offset), &heap);
+        checksum += route.size() + values.back().size();
+    });
+
+    CountingResource upstream(std::pmr::new_delete_resource());
+    CES::Arena arena(4096, &upstream);
+    measure("arena, reset per message", encoded, upstream, [&](std::span<const std::byte> bytes) {
+        {
+            const std::size_t offset = CES::BinaryConverter::skip(bytes);
+            auto route = CES::BinaryConverter::deserialize<std::pmr::string>(bytes, &arena);
+            auto values = CES::BinaryConverter::deserialize<std::pmr::vector<std::pmr::string>>(bytes.subspan(offset), &arena);
+            checksum += route.size() + values.back().size();
+        }
+        arena.reset();
+    });
+    if (checksum == 0) std::printf("empty messages\n");
+}
@@ -0,0 +1,89 @@
+/**
+ * @file array_bench.cpp
+ * @brief Measures the throughput of array deserialization.
+ * @details Compares the per-element read loop the converter used to do against the bulk read, for data
+ * serialized on a system with the same and with the opposite endianess. Everything runs on an in-memory
+ * stream, so the numbers show the cost of the converter rather than the cost of the disk.
+ * @copyright CES Public License
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include "../inc/BinaryConverter.hpp"
+#include "Bench.hpp"
+
+namespace {
+    constexpr std::size_t elements = 1 << 22;
+    constexpr int repetitions = 10;
+
+    double source[elements];
+    double destination[elements];
+    char host_flag; // the system flag this machine writes.
+
+    /*
+     * The deserialization loop before the bulk read: one istream.read per element, then one swap per element.
+     * The per-element swap is a byte reverse, the old switch_bytes could not handle doubles.
+     */
+    void legacy_deserialize(double (&arr)[elements], std::istream &istream) {
+        char sts_char, t_char;
+        std::size_t size;
+        istream.get(sts_char);
+        istream.get(t_char);
+        istream.read(reinterpret_cast<char *>(&size), sizeof(size_t));
+        if (sts_char != host_flag) size = CES::ByteSwapper::swap(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            istream.read(reinterpret_cast<char *>(&arr[i]), sizeof(double));
+        }
+        if (sts_char != host_flag) {
+            for (std::size_t i = 0; i < size; ++i) {
+                auto *bytes = reinterpret_cast<unsigned char *>(&arr[i]);
+                std::reverse(bytes, bytes + sizeof(double));
+            }
+        }
+    }
+
+    template<typename F>
+    double best_gbps(const std::string &data, F &&deserialize) {
+        double best = 0;
+        for (int r = 0; r < repetitions; ++r) {
+            std::istringstream in(data);
+            const auto start = std::chrono::steady_clock::now();
+            deserialize(in);
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::max(best, static_cast<double>(sizeof(destination)) / elapsed.count() / 1e9);
+        }
+        return best;
+    }
+}
+
+void run_array_bench() {
+    for (std::size_t i = 0; i < elements; ++i) source[i] = static_cast<double>(i) * 0.5;
+
+    std::ostringstream out;
+    CES::BinaryConverter::serialize(source, out);
+    const std::string same_endian = out.str();
+    host_flag = same_endian[0];
+    std::string cross_endian = same_endian; // what a system with the other byte order would have written.
+    cross_endian[0] = static_cast<char>(same_endian[0] == LE ? BE : LE);
+    std::reverse(cross_endian.begin() + 2, cross_endian.begin() + 2 + sizeof(std::size_t));
+    for (std::size_t offset = 2 + sizeof(std::size_t); offset < cross_endian.size(); offset += sizeof(double)) {
+        std::reverse(cross_endian.begin() + static_cast<long>(offset),
+                     cross_endian.begin() + static_cast<long>(offset + sizeof(double)));
+    }
+
+    const double legacy_same = best_gbps(same_endian, [](std::istream &in) { legacy_deserialize(destination, in); });
+    const double bulk_same = best_gbps(same_endian, [](std::istream &in) {
+        CES::BinaryConverter::deserialize(destination, in);
+    });
+    const double legacy_cross = best_gbps(cross_endian, [](std::istream &in) { legacy_deserialize(destination, in); });
+    const double bulk_cross = best_gbps(cross_endian, [](std::istream &in) {
+        CES::BinaryConverter::deserialize(destination, in);
+    });
+
+    std::printf("DOUBLE_ARRAY, %zu elements (%.1f MB)\n", elements, sizeof(destination) / 1e6);
+    std::printf("%-14s %12s %12s\n", "", "per-element", "bulk");
+    std::printf("%-14s %9.2f GB/s %7.2f GB/s\n", "same endian", legacy_same, bulk_same);
+    std::printf("%-14s %9.2f GB/s %7.2f GB/s\n", "cross endian", legacy_cross, bulk_cross);
+}
@@ -0,0 +1,86 @@
+/**
+ * @file async_bench.cpp
+ * @brief Measures the AsyncWriter and the AsyncReader against serializing to and from file streams.
+ * @details A file of 512 DOUBLE_ARRAY values of 256 KiB each is written and read back value by value, every value
+ * read is summed to stand in for the work done with it. The file is in the page cache after the first pass, so the
+ * rates show the overlap of the copies with the encoding and decoding rather than the speed of the disk. Rates are
+ * in MB/s of array data.
+ * @copyright CES Public License
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <vector>
+#include "../inc/AsyncIO.hpp"
+#include "Bench.hpp"
+
+namespace {
+    constexpr std::size_t arrays = 512;
+    constexpr std::size_t elements = 1 << 15;
+    constexpr int repetitions = 3;
+
+    /*
+     * Best rate in MB/s for processing the file once.
+     */
+    template<typename F>
+    double best_mbps(F &&run) {
+        double best = 0;
+        for (int r = 0; r < repetitions; ++r) {
+            const auto start = std::chrono::steady_clock::now();
+            run();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::max(best, arrays * elements * sizeof(double) / elapsed.count() / 1e6);
+        }
+        return best;
+    }
+}
+
+void run_async_bench() {
+    const std::string path = (std::filesystem::temp_directory_path() / "ces_async_bench.bin").string();
+    std::vector<double> values(elements);
+    for (std::size_t i = 0; i < elements; ++i) values[i] = static_cast<double>(i % 1000) / 8;
+
+    std::printf("%zu DOUBLE_ARRAY values of %zu KiB\n", arrays, elements * sizeof(double) >> 10);
+    std::printf("%-16s %14s %14s\n", "backend", "write", "read");
+
+    double sum = 0;
+    std::vector<double> destination;
+    const double stream_write = best_mbps([&] {
+        std::ofstream ostream(path, std::ios::binary);
+        for (std::size_t a = 0; a < arrays; ++a) CES::BinaryConverter::serialize(values, ostream);
+    });
+    const double stream_read = best_mbps([&] {
+        std::ifstream istream(path, std::ios::binary);
+        for (std::size_t a = 0; a < arrays; ++a) {
+            CES::BinaryConverter::deserialize(destination, istream);
+            sum += std::accumulate(destination.begin(), destination.end(), 0.0);
+        }
+    });
+    std::printf("%-16s %9.0f MB/s %9.0f MB/s\n", "fstream", stream_write, stream_read);
+
+    for (const bool use_io_uring: {true, false}) {
+        bool uring = false;
+        const double write = best_mbps([&] {
+            CES::AsyncWriter writer(path, 1 << 20, use_io_uring);
+            uring = writer.uses_io_uring();
+            for (std::size_t a = 0; a < arrays; ++a) writer.write(values);
+            writer.flush();
+        });
+        const double read = best_mbps([&] {
+            CES::AsyncReader reader(path, 1 << 20, use_io_uring);
+            for (std::size_t a = 0; a < arrays; ++a) {
+                reader.read(destination);
+                sum += std::accumulate(destination.begin(), destination.end(), 0.0);
+            }
+        });
+        std::printf("%-16s %9.0f MB/s %9.0f MB/s%s\n", uring ? "async io_uring" : "async thread", write, read,
+                    destination == values ? "" : " (mismatch)");
+        if (!uring) break; // no io_uring here, the first pass already used the thread.
+    }
+    std::filesystem::remove(path);
+    if (sum < 0) std::printf("%f\n", sum); // keeps the sums.
+}
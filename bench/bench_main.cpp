@@ -0,0 +1,85 @@
+/**
+ * @file bench_main.cpp
+ * @brief Runs every benchmark of binary_data_processing_bench.
+ * @details Without arguments every benchmark runs and the matrix of suite_bench.cpp comes last. Options:
+ * --suite runs the matrix only, --max-bytes N (K, M and G suffixes) sets its largest array, --min-time S the
+ * seconds per measurement, --filter NAME keeps the type names that contain NAME, --csv PATH and --json PATH write
+ * its results for tracking them across releases.
+ * @copyright CES Public License
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "Bench.hpp"
+
+namespace {
+    /*
+     * Parses a byte count like 512K, 64M or 2G.
+     */
+    std::size_t parse_bytes(const char *text) {
+        char *end;
+        std::size_t bytes = std::strtoull(text, &end, 10);
+        switch (*end) {
+            case 'G': bytes <<= 10; [[fallthrough]];
+            case 'M': bytes <<= 10; [[fallthrough]];
+            case 'K': bytes <<= 10; break;
+            default: break;
+        }
+        return bytes;
+    }
+
+    int usage() {
+        std::fprintf(stderr, "usage: binary_data_processing_bench [--suite] [--max-bytes N[K|M|G]] [--min-time S] "
+                             "[--filter NAME] [--csv PATH] [--json PATH]\n");
+        return 1;
+    }
+}
+
+int main(int argc, char **argv) {
+    SuiteOptions options;
+    bool suite_only = false;
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--suite") == 0) suite_only = true;
+        else if (std::strcmp(argv[i], "--max-bytes") == 0 && has_value) options.max_bytes = parse_bytes(argv[++i]);
+        else if (std::strcmp(argv[i], "--min-time") == 0 && has_value) options.min_time = std::strtod(argv[++i], nullptr);
+        else if (std::strcmp(argv[i], "--filter") == 0 && has_value) options.filter = argv[++i];
+        else if (std::strcmp(argv[i], "--csv") == 0 && has_value) options.csv = argv[++i];
+        else if (std::strcmp(argv[i], "--json") == 0 && has_value) options.json = argv[++i];
+        else return usage();
+    }
+
+    if (!suite_only) {
+        run_array_bench();
+        std::printf("\n");
+        run_scalar_bench();
+        std::printf("\n");
+        run_record_bench();
+        std::printf("\n");
+        run_varint_bench();
+        std::printf("\n");
+        run_series_bench();
+        std::printf("\n");
+        run_dictionary_bench();
+        std::printf("\n");
+        run_column_bench();
+        std::printf("\n");
+        run_compression_bench();
+        std::printf("\n");
+        run_checksum_bench();
+        std::printf("\n");
+        run_zone_map_bench();
+        std::printf("\n");
+        run_parallel_bench();
+        std::printf("\n");
+        run_async_bench();
+        std::printf("\n");
+        run_shared_ring_bench();
+        std::printf("\n");
+        run_arena_bench();
+        std::printf("\n");
+    }
+    run_suite_bench(options);
+    return 0;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file checksum_bench.cpp
+ * @brief Measures CRC32C and the checksummed frame against plain serialization.
+ * @details The raw rates are CRC32C alone, a memcpy and the copy that computes the CRC32C on the way. The frame rates
+ * write and read a DOUBLE_ARRAY through a stringstream, plain and checksummed, and read one value at the start of a
+ * frame in memory with every block checked and with lazy checks.
+ * @copyright CES Public License
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <vector>
+#include "../inc/Checksum.hpp"
+#include "Bench.hpp"
+
+namespace {
+    constexpr std::size_t elements = 1 << 22;
+    constexpr std::size_t bytes = elements * sizeof(double);
+    constexpr int repetitions = 10;
+
+    /*
+     * Best rate in GB/s of the array bytes.
+     */
+    template<typename F>
+    double best_gbps(F &&run) {
+        double best = 0;
+        for (int r = 0; r < repetitions; ++r) {
+            const auto start = std::chrono::steady_clock::now();
+            run();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::max(best, static_cast<double>(bytes) / elapsed.count() / 1e9);
+        }
+        return best;
+    }
+}
+
+void run_checksum_bench() {
+    std::mt19937_64 random(42);
+    std::vector<double> values(elements);
+    for (double &value: values) value = static_cast<double>(random() % 100000) / 7;
+    const auto raw = std::as_bytes(std::span(values));
+    std::vector<std::byte> copy(bytes);
+
+    std::uint32_t crc = 0;
+    const double crc_rate = best_gbps([&] { crc += CES::Crc32c::compute(raw); });
+    const double memcpy_rate = best_gbps([&] { std::memcpy(copy.data(), raw.data(), bytes); });
+    const double copy_rate = best_gbps([&] { crc ^= CES::Crc32c::copy(copy.data(), raw); });
+
+    std::stringstream plain, checked;
+    std::vector<double> destination;
+    const double plain_write = best_gbps([&] {
+        plain.str({});
+        CES::BinaryConverter::serialize(values, plain);
+    });
+    const double checked_write = best_gbps([&] {
+        checked.str({});
+        CES::ChecksummedWriter writer(checked);
+        writer.write(values);
+    });
+    const double plain_read = best_gbps([&] {
+        plain.seekg(0);
+        CES::BinaryConverter::deserialize(destination, plain);
+    });
+    const double checked_read = best_gbps([&] {
+        checked.clear();
+        checked.seekg(0);
+        CES::ChecksummedReader reader(checked);
+        reader.read(destination);
+    });
+
+    const std::string frame = checked.str();
+    const auto frame_bytes = std::as_bytes(std::span(frame.data(), frame.size()));
+    const double eager_open = best_gbps([&] { CES::ChecksummedReader reader(frame_bytes); });
+    const double lazy_open = best_gbps([&] {
+        CES::ChecksummedReader reader(frame_bytes, true);
+        reader.skip_value();
+    });
+
+    std::printf("CRC32C (%s), DOUBLE_ARRAY of %zu elements, crc %08x%s\n", CES::Crc32c::hardware() ? "crc32 instruction" : "table",
+                elements, static_cast<unsigned>(crc), destination == values ? "" : " (mismatch)");
+    std::printf("%-22s %8.2f GB/s\n", "crc32c", crc_rate);
+    std::printf("%-22s %8.2f GB/s\n", "memcpy", memcpy_rate);
+    std::printf("%-22s %8.2f GB/s\n", "copy + crc32c", copy_rate);
+    std::printf("%-22s %14s %14s\n", "", "plain", "checksummed");
+    std::printf("%-22s %8.2f GB/s %8.2f GB/s\n", "stream write", plain_write, checked_write);
+    std::printf("%-22s %8.2f GB/s %8.2f GB/s\n", "stream read", plain_read, checked_read);
+    std::printf("%-22s %14s %8.2f GB/s\n", "open, check all", "", eager_open);
+    std::printf("%-22s %14s %8.2f GB/s\n", "open lazy + skip", "", lazy_open);
+}
@@ -0,0 +1,75 @@
+/**
+ * @file column_bench.cpp
+ * @brief Measures reading one field of a record array: one STRUCT value per record against a single column of
+ * the COLUMNS encoding.
+ * @details The records are written once per encoding. The row-wise read decodes every record to get at the price,
+ * the columnar read decodes only the price column and never touches the bytes of the other fields.
+ * @copyright CES Public License
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../inc/Columns.hpp"
+#include "Bench.hpp"
+
+namespace {
+    constexpr std::size_t rows = 1 << 18;
+    constexpr int repetitions = 10;
+
+    struct Trade {
+        long time;
+        double price;
+        int quantity;
+        std::string symbol;
+        CES_FIELDS(time, price, quantity, symbol)
+    };
+
+    /*
+     * Best read rate in millions of rows per second.
+     */
+    template<typename F>
+    double best_mrps(F &&run) {
+        double best = 0;
+        for (int r = 0; r < repetitions; ++r) {
+            const auto start = std::chrono::steady_clock::now();
+            run();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::max(best, rows / elapsed.count() / 1e6);
+        }
+        return best;
+    }
+}
+
+void run_column_bench() {
+    std::vector<Trade> trades(rows);
+    for (std::size_t i = 0; i < rows; ++i)
+        trades[i] = {static_cast<long>(i) * 1000, 100.0 + static_cast<double>(i % 500) / 8, static_cast<int>(i % 900),
+                     i % 3 == 0 ? "EURUSD" : "GBPJPY"};
+
+    CES::ByteBuffer records, columns;
+    for (const Trade &trade: trades) CES::BinaryConverter::serialize(trade, records);
+    CES::BinaryConverter::serialize(CES::columnar(trades), columns);
+
+    std::vector<double> prices(rows);
+    const double row_read = best_mrps([&] {
+        std::span<const std::byte> remaining = records.span();
+        Trade trade;
+        for (std::size_t i = 0; i < rows; ++i) {
+            remaining = remaining.subspan(CES::BinaryConverter::deserialize(trade, remaining));
+            prices[i] = trade.price;
+        }
+    });
+    bool match = prices[rows - 1] == trades[rows - 1].price;
+    const double column_read = best_mrps([&] {
+        CES::ColumnReader reader(columns.span());
+        reader.read(&Trade::price, prices);
+    });
+    match = match && prices[rows - 1] == trades[rows - 1].price;
+
+    std::printf("Price field of %zu records%s\n", rows, match ? "" : " (mismatch)");
+    std::printf("%-14s %14s %14s\n", "", "STRUCT", "COLUMNS");
+    std::printf("%-14s %9.1f M/s %9.1f M/s\n", "read", row_read, column_read);
+    std::printf("%-14s %11zu B %12zu B\n", "size", records.size(), columns.size());
+}
@@ -0,0 +1,78 @@
+/**
+ * @file compression_bench.cpp
+ * @brief Measures the block compression stage: ratio, compression speed and decompression speed on one thread and
+ * on every hardware thread, with and without the byte shuffle.
+ * @details The data are a DOUBLE_ARRAY of prices that move in cents and a LONG_ARRAY of increasing timestamps.
+ * Speeds are in MB/s of decompressed data.
+ * @copyright CES Public License
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+#include "../inc/Compression.hpp"
+#include "Bench.hpp"
+
+namespace {
+    constexpr std::size_t elements = 1 << 22;
+    constexpr int repetitions = 5;
+
+    /*
+     * Best rate in MB/s for processing bytes bytes.
+     */
+    template<typename F>
+    double best_mbps(std::size_t bytes, F &&run) {
+        double best = 0;
+        for (int r = 0; r < repetitions; ++r) {
+            const auto start = std::chrono::steady_clock::now();
+            run();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::max(best, static_cast<double>(bytes) / elapsed.count() / 1e6);
+        }
+        return best;
+    }
+
+    void measure(const char *name, const CES::ByteBuffer &raw, std::size_t width) {
+        CES::ByteBuffer frame, restored;
+        const double compress = best_mbps(raw.size(), [&] {
+            frame.clear();
+            CES::Compressor::compress(raw.span(), frame, width);
+        });
+        const double single = best_mbps(raw.size(), [&] {
+            restored.clear();
+            CES::Compressor::decompress(frame.span(), restored, 1);
+        });
+        const double parallel = best_mbps(raw.size(), [&] {
+            restored.clear();
+            CES::Compressor::decompress(frame.span(), restored);
+        });
+        const bool match = restored.size() == raw.size() && std::memcmp(restored.data(), raw.data(), raw.size()) == 0;
+        std::printf("%-22s %7.2fx %9.0f MB/s %9.0f MB/s %9.0f MB/s%s\n", name,
+                    static_cast<double>(raw.size()) / static_cast<double>(frame.size()), compress, single, parallel,
+                    match ? "" : " (mismatch)");
+    }
+}
+
+void run_compression_bench() {
+    std::mt19937_64 random(42);
+    std::vector<double> prices(elements);
+    double price = 100;
+    for (double &p: prices) p = price += static_cast<double>(static_cast<int>(random() % 21) - 10) / 100;
+    std::vector<long> timestamps(elements);
+    long time = 1700000000000;
+    for (long &t: timestamps) t = time += static_cast<long>(random() % 50);
+
+    CES::ByteBuffer price_bytes, time_bytes;
+    CES::BinaryConverter::serialize(prices, price_bytes);
+    CES::BinaryConverter::serialize(timestamps, time_bytes);
+
+    std::printf("Block compression, %zu elements, %u hardware threads\n", elements, std::thread::hardware_concurrency());
+    std::printf("%-22s %8s %14s %14s %14s\n", "", "ratio", "compress", "1 thread", "all threads");
+    measure("DOUBLE_ARRAY", price_bytes, 1);
+    measure("DOUBLE_ARRAY shuffled", price_bytes, 8);
+    measure("LONG_ARRAY", time_bytes, 1);
+    measure("LONG_ARRAY shuffled", time_bytes, 8);
+}
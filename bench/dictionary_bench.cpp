@@ -0,0 +1,66 @@
+/**
+ * @file dictionary_bench.cpp
+ * @brief Measures the size and the decode speed of dictionary encoded string arrays against plain STRING_ARRAY payloads.
+ * @details The data are hostnames drawn from 64 distinct values. The dictionary encoding is read back twice: into
+ * std::vector<std::string>, which materializes every string, and into CodedStrings, which keeps the codes; the
+ * filter counts the strings equal to one hostname, by comparing strings and by comparing codes.
+ * @copyright CES Public License
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "../inc/BinaryConverter.hpp"
+#include "Bench.hpp"
+
+namespace {
+    constexpr std::size_t elements = 1 << 20;
+    constexpr int repetitions = 10;
+
+    /*
+     * Best rate in millions of strings per second.
+     */
+    template<typename F>
+    double best_mvps(F &&run) {
+        double best = 0;
+        for (int r = 0; r < repetitions; ++r) {
+            const auto start = std::chrono::steady_clock::now();
+            run();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::max(best, elements / elapsed.count() / 1e6);
+        }
+        return best;
+    }
+}
+
+void run_dictionary_bench() {
+    std::mt19937_64 random(42);
+    std::vector<std::string> hosts(elements);
+    for (std::string &host: hosts) host = "node-" + std::to_string(random() % 64) + ".eu-west.example.com";
+
+    CES::ByteBuffer plain, coded;
+    CES::BinaryConverter::serialize(hosts, plain);
+    CES::BinaryConverter::serialize(CES::dictionary(hosts), coded);
+
+    std::vector<std::string> strings;
+    CES::CodedStrings codes;
+    const double plain_read = best_mvps([&] { CES::BinaryConverter::deserialize(strings, plain.span()); });
+    const double coded_read = best_mvps([&] { CES::BinaryConverter::deserialize(strings, coded.span()); });
+    const double codes_read = best_mvps([&] { CES::BinaryConverter::deserialize(codes, coded.span()); });
+
+    const std::string wanted = hosts[0];
+    std::size_t by_string = 0, by_code = 0;
+    const double string_filter = best_mvps([&] { by_string = std::count(strings.begin(), strings.end(), wanted); });
+    const double code_filter = best_mvps([&] {
+        const std::uint32_t code = codes.find(wanted).value();
+        by_code = std::count(codes.codes().begin(), codes.codes().end(), code);
+    });
+
+    std::printf("STRING_ARRAY of hostnames, 64 distinct, %zu elements%s\n", elements, by_string == by_code ? "" : " (mismatch)");
+    std::printf("%-14s %14s %14s %14s\n", "", "plain", "dictionary", "codes");
+    std::printf("%-14s %9.1f M/s %9.1f M/s %9.1f M/s\n", "read", plain_read, coded_read, codes_read);
+    std::printf("%-14s %9.1f M/s %14s %9.1f M/s\n", "filter", string_filter, "", code_filter);
+    std::printf("%-14s %11zu B %12zu B\n", "size", plain.size(), coded.size());
+}
@@ -0,0 +1,92 @@
+/**
+ * @file parallel_bench.cpp
+ * @brief Measures how the ParallelConverter and the Compressor scale from 1 to every hardware thread.
+ * @details A DOUBLE_ARRAY of 128 MiB is written, read back, read back with swapped bytes, compressed and decompressed
+ * by pools of 1, 2, 4 ... threads. Rates are in MB/s of array data.
+ * @copyright CES Public License
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "../inc/Compression.hpp"
+#include "../inc/ParallelConverter.hpp"
+#include "Bench.hpp"
+
+namespace {
+    constexpr std::size_t elements = 1 << 24;
+    constexpr int repetitions = 3;
+
+    /*
+     * Best rate in MB/s for processing the array once.
+     */
+    template<typename F>
+    double best_mbps(F &&run) {
+        double best = 0;
+        for (int r = 0; r < repetitions; ++r) {
+            const auto start = std::chrono::steady_clock::now();
+            run();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::max(best, elements * sizeof(double) / elapsed.count() / 1e6);
+        }
+        return best;
+    }
+
+    /*
+     * The same bytes as serialized on a system with the other byte order.
+     */
+    CES::ByteBuffer swapped_copy(const CES::ByteBuffer &native) {
+        CES::ByteBuffer swapped;
+        swapped.write(native.data(), native.size());
+        swapped.data()[0] = static_cast<std::byte>(static_cast<unsigned char>(swapped.data()[0]) ^ 1);
+        std::size_t size;
+        std::memcpy(&size, swapped.data() + 2, sizeof(size));
+        size = CES::ByteSwapper::swap(size);
+        std::memcpy(swapped.data() + 2, &size, sizeof(size));
+        std::vector<double> values(elements);
+        std::memcpy(values.data(), swapped.data() + 2 + sizeof(size), elements * sizeof(double));
+        CES::ByteSwapper::swap_in_place(values.data(), elements);
+        std::memcpy(swapped.data() + 2 + sizeof(size), values.data(), elements * sizeof(double));
+        return swapped;
+    }
+}
+
+void run_parallel_bench() {
+    std::vector<double> values(elements);
+    for (std::size_t i = 0; i < elements; ++i) values[i] = 100.0 + static_cast<double>(i % 10000) / 100;
+
+    CES::ByteBuffer native;
+    CES::BinaryConverter::serialize(values, native);
+    const CES::ByteBuffer swapped = swapped_copy(native);
+    CES::ByteBuffer frame;
+    CES::Compressor::compress(native.span(), frame, 8);
+
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("DOUBLE_ARRAY of %zu MiB, %u hardware threads\n", elements * sizeof(double) >> 20, hardware);
+    std::printf("%-8s %14s %14s %14s %14s %14s\n", "threads", "write", "read", "read swapped", "compress", "decompress");
+
+    std::vector<double> destination;
+    CES::ByteBuffer buffer;
+    for (unsigned threads = 1;; threads = std::min(threads * 2, hardware)) {
+        CES::ThreadPool pool(threads);
+        const double write = best_mbps([&] {
+            buffer.clear();
+            CES::ParallelConverter::serialize(values, buffer, pool);
+        });
+        const double read = best_mbps([&] { CES::ParallelConverter::deserialize(destination, native.span(), pool); });
+        const double read_swapped = best_mbps([&] { CES::ParallelConverter::deserialize(destination, swapped.span(), pool); });
+        const double compress = best_mbps([&] {
+            buffer.clear();
+            CES::Compressor::compress(native.span(), buffer, pool, 8);
+        });
+        const double decompress = best_mbps([&] {
+            buffer.clear();
+            CES::Compressor::decompress(frame.span(), buffer, pool);
+        });
+        std::printf("%-8u %9.0f MB/s %9.0f MB/s %9.0f MB/s %9.0f MB/s %9.0f MB/s%s\n", threads, write, read, read_swapped,
+                    compress, decompress, destination == values ? "" : " (mismatch)");
+        if (threads == hardware) break;
+    }
+}
@@ -0,0 +1,84 @@
+/**
+ * @file record_bench.cpp
+ * @brief Measures small-record throughput: one serialize call per value against the RecordWriter/RecordReader.
+ * @copyright CES Public License
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../inc/RecordStream.hpp"
+#include "Bench.hpp"
+
+namespace {
+    constexpr int values = 1 << 20;
+    constexpr int repetitions = 5;
+
+    /*
+     * Best throughput in millions of values per second.
+     */
+    template<typename F>
+    double best_mvps(F &&run) {
+        double best = 0;
+        for (int r = 0; r < repetitions; ++r) {
+            const auto start = std::chrono::steady_clock::now();
+            run();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::max(best, values / elapsed.count() / 1e6);
+        }
+        return best;
+    }
+}
+
+void run_record_bench() {
+    long long sum = 0;
+    std::string per_value, records;
+
+    const double write_per_value = best_mvps([&] {
+        std::ostringstream out;
+        for (int i = 0; i < values; ++i) CES::BinaryConverter::serialize(i, out);
+        per_value = out.str();
+    });
+    const double write_records = best_mvps([&] {
+        std::ostringstream out;
+        CES::RecordWriter writer(out);
+        for (int i = 0; i < values; ++i) writer.write(i);
+        writer.flush();
+        records = out.str();
+    });
+    const double read_per_value = best_mvps([&] {
+        std::istringstream in(per_value);
+        int value;
+        for (int i = 0; i < values; ++i) {
+            CES::BinaryConverter::deserialize(value, in);
+            sum += value;
+        }
+    });
+    const double read_records = best_mvps([&] {
+        std::istringstream in(records);
+        CES::RecordReader reader(in);
+        while (reader.next()) sum += reader.get<int>();
+    });
+
+    std::printf("INT records, %d values%s\n", values, sum == 0 ? " " : "");
+    std::printf("%-14s %14s %14s\n", "", "per value", "RecordWriter");
+    std::printf("%-14s %9.1f M/s %9.1f M/s\n", "write", write_per_value, write_records);
+    std::printf("%-14s %9.1f M/s %9.1f M/s\n", "read", read_per_value, read_records);
+    std::printf("%-14s %11zu B %12zu B\n", "size", per_value.size(), records.size());
+
+    // a dictionary of strings that hardly repeat falls back to a plain STRING_ARRAY, the record has to say so.
+    const std::vector<std::string> distinct = {"alpha", "beta", "gamma"}, repeated(64, "alpha");
+    std::ostringstream out;
+    {
+        CES::RecordWriter writer(out);
+        writer.write(CES::dictionary(distinct));
+        writer.write(CES::dictionary(repeated));
+    }
+    std::istringstream in(out.str());
+    CES::RecordReader reader(in);
+    const bool plain = reader.next() && reader.current_type() == STRING_ARRAY && reader.get<std::vector<std::string>>() == distinct;
+    const bool coded = reader.next() && reader.current_type() == DICTIONARY_STRING_ARRAY && reader.get<std::vector<std::string>>() == repeated;
+    std::printf("%-14s %14s %14s\n", "dictionary", plain ? "plain ok" : "plain mismatch", coded ? "coded ok" : "coded mismatch");
+}
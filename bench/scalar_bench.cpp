@@ -0,0 +1,194 @@
+/**
+ * @file scalar_bench.cpp
+ * @brief Measures the cost of serializing and deserializing single values.
+ * @details The values go through a ByteBuffer, so what is left is the header and the type dispatch. The legacy
+ * functions reproduce the dispatch the converter used before type_tag_v: a typeid chain to find the type flag
+ * when writing and a switch with a typeid comparison per case when reading. A small struct is also measured field by
+ * field, with a header per field, against a single STRUCT value.
+ * @copyright CES Public License
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <typeinfo>
+#include "../inc/BinaryConverter.hpp"
+#include "Bench.hpp"
+
+namespace {
+    constexpr std::size_t values = 1 << 20;
+    constexpr int repetitions = 10;
+
+    template<typename T>
+    type legacy_find_type() {
+        if (typeid(T) == typeid(int)) return INT;
+        else if (typeid(T) == typeid(unsigned int)) return UNSIGNED_INT;
+        else if (typeid(T) == typeid(short)) return SHORT;
+        else if (typeid(T) == typeid(unsigned short)) return UNSIGNED_SHORT;
+        else if (typeid(T) == typeid(long)) return LONG;
+        else if (typeid(T) == typeid(unsigned long)) return UNSIGNED_LONG;
+        else if (typeid(T) == typeid(long long)) return LONG_LONG;
+        else if (typeid(T) == typeid(unsigned long long)) return UNSIGNED_LONG_LONG;
+        else if (typeid(T) == typeid(float)) return FLOAT;
+        else if (typeid(T) == typeid(double)) return DOUBLE;
+        else if (typeid(T) == typeid(long double)) return LONG_DOUBLE;
+        else if (typeid(T) == typeid(char)) return CHAR;
+        else if (typeid(T) == typeid(unsigned char)) return UNSIGNED_CHAR;
+        else if (typeid(T) == typeid(bool)) return BOOL;
+        else throw std::invalid_argument("Type not supported");
+    }
+
+    template<typename T>
+    void legacy_serialize(const T &obj, CES::ByteBuffer &buffer) {
+        const auto st = static_cast<char>(LE);
+        const auto t = static_cast<char>(legacy_find_type<T>());
+        buffer.write(&st, 1);
+        buffer.write(&t, 1);
+        buffer.write(&obj, sizeof(T));
+    }
+
+#define LEGACY_CASE(tag, cpp_type) \
+    case tag: \
+        if (typeid(cpp_type) != typeid(T)) throw std::invalid_argument("Object type does not match serialized data type"); \
+        { \
+            cpp_type value; \
+            reader.read(&value, sizeof(cpp_type)); \
+            std::memcpy(&obj, &value, std::min(sizeof(T), sizeof(cpp_type))); \
+        } \
+        break;
+
+    template<typename T>
+    void legacy_deserialize(T &obj, CES::ByteReader &reader) {
+        char header[2];
+        reader.read(header, 2);
+        switch (static_cast<type>(header[1])) {
+            LEGACY_CASE(INT, int)
+            LEGACY_CASE(UNSIGNED_INT, unsigned int)
+            LEGACY_CASE(SHORT, short)
+            LEGACY_CASE(UNSIGNED_SHORT, unsigned short)
+            LEGACY_CASE(LONG, long)
+            LEGACY_CASE(UNSIGNED_LONG, unsigned long)
+            LEGACY_CASE(LONG_LONG, long long)
+            LEGACY_CASE(UNSIGNED_LONG_LONG, unsigned long long)
+            LEGACY_CASE(FLOAT, float)
+            LEGACY_CASE(DOUBLE, double)
+            LEGACY_CASE(LONG_DOUBLE, long double)
+            LEGACY_CASE(CHAR, char)
+            LEGACY_CASE(UNSIGNED_CHAR, unsigned char)
+            LEGACY_CASE(BOOL, bool)
+            default:
+                throw std::invalid_argument("Data type not accepted");
+        }
+    }
+
+#undef LEGACY_CASE
+
+    struct Quote {
+        long time;
+        double bid;
+        double ask;
+        int size;
+        int venue;
+        CES_FIELDS(time, bid, ask, size, venue)
+    };
+
+    /*
+     * Best time per struct round-trip in nanoseconds.
+     */
+    template<typename Write, typename Read>
+    double best_struct_ns(Write &&write, Read &&read) {
+        CES::ByteBuffer buffer(values * 64);
+        double best = 1e30;
+        long sum = 0;
+        for (int r = 0; r < repetitions; ++r) {
+            buffer.clear();
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < values; ++i) {
+                const auto n = static_cast<long>(i);
+                write(Quote{n, 1.5, 2.5, static_cast<int>(n), 3}, buffer);
+            }
+            CES::ByteReader reader(buffer.span());
+            for (std::size_t i = 0; i < values; ++i) {
+                Quote quote{};
+                read(quote, reader);
+                sum += quote.time;
+            }
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min(best, elapsed.count() / values);
+        }
+        if (sum == 1) std::printf(" ");
+        return best;
+    }
+
+    template<typename T>
+    void read_next(T &obj, CES::ByteReader &reader) {
+        reader.take(CES::BinaryConverter::deserialize(obj, std::span<const std::byte>(reader.current(), reader.remaining())));
+    }
+
+    /*
+     * Best time per round-trip (serialize and deserialize one value) in nanoseconds.
+     */
+    template<typename T, typename Write, typename Read>
+    double best_ns(Write &&write, Read &&read) {
+        CES::ByteBuffer buffer(values * (2 + sizeof(T)));
+        double best = 1e30;
+        T sum{};
+        for (int r = 0; r < repetitions; ++r) {
+            buffer.clear();
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < values; ++i) write(static_cast<T>(i), buffer);
+            CES::ByteReader reader(buffer.span());
+            for (std::size_t i = 0; i < values; ++i) {
+                T value;
+                read(value, reader);
+                sum += value;
+            }
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min(best, elapsed.count() / values);
+        }
+        if (sum == T{1}) std::printf(" "); // keeps the reads alive.
+        return best;
+    }
+
+    template<typename T>
+    void report(const char *name) {
+        const double legacy = best_ns<T>([](const T &v, CES::ByteBuffer &b) { legacy_serialize(v, b); },
+                                         [](T &v, CES::ByteReader &r) { legacy_deserialize(v, r); });
+        const double tagged = best_ns<T>([](const T &v, CES::ByteBuffer &b) { CES::BinaryConverter::serialize(v, b); },
+                                         [](T &v, CES::ByteReader &r) {
+                                             const std::size_t used = CES::BinaryConverter::deserialize(
+                                                     v, std::span<const std::byte>(r.current(), r.remaining()));
+                                             r.take(used);
+                                         });
+        std::printf("%-14s %9.2f ns %9.2f ns\n", name, legacy, tagged);
+    }
+}
+
+void run_scalar_bench() {
+    std::printf("Scalar round-trip through a ByteBuffer, %zu values\n", values);
+    std::printf("%-14s %12s %12s\n", "", "typeid", "type_tag_v");
+    report<int>("int");
+    report<double>("double");
+    report<unsigned short>("unsigned short");
+    report<long long>("long long");
+
+    const double per_field = best_struct_ns(
+            [](const Quote &q, CES::ByteBuffer &b) {
+                CES::BinaryConverter::serialize(q.time, b);
+                CES::BinaryConverter::serialize(q.bid, b);
+                CES::BinaryConverter::serialize(q.ask, b);
+                CES::BinaryConverter::serialize(q.size, b);
+                CES::BinaryConverter::serialize(q.venue, b);
+            },
+            [](Quote &q, CES::ByteReader &r) {
+                read_next(q.time, r);
+                read_next(q.bid, r);
+                read_next(q.ask, r);
+                read_next(q.size, r);
+                read_next(q.venue, r);
+            });
+    const double fused = best_struct_ns([](const Quote &q, CES::ByteBuffer &b) { CES::BinaryConverter::serialize(q, b); },
+                                        [](Quote &q, CES::ByteReader &r) { read_next(q, r); });
+    std::printf("\n%-14s %12s %12s\n", "", "per field", "STRUCT");
+    std::printf("%-14s %9.2f ns %9.2f ns\n", "5 field struct", per_field, fused);
+}
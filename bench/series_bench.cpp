@@ -0,0 +1,69 @@
+/**
+ * @file series_bench.cpp
+ * @brief Measures the size and the decode speed of the time series encodings against native arrays.
+ * @details Timestamps one second apart with a few milliseconds of jitter, written as a LONG_LONG_ARRAY, as deltas and
+ * as deltas of deltas, and temperature readings that change by hundredths of a degree, written as a DOUBLE_ARRAY
+ * and as XORs. Everything is decoded from memory, like the varint bench.
+ * @copyright CES Public License
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "../inc/BinaryConverter.hpp"
+#include "Bench.hpp"
+
+namespace {
+    constexpr std::size_t elements = 1 << 22;
+    constexpr int repetitions = 10;
+
+    /*
+     * Best decode rate in millions of values per second.
+     */
+    template<typename F>
+    double best_mvps(F &&run) {
+        double best = 0;
+        for (int r = 0; r < repetitions; ++r) {
+            const auto start = std::chrono::steady_clock::now();
+            run();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::max(best, elements / elapsed.count() / 1e6);
+        }
+        return best;
+    }
+
+    template<typename T>
+    void report(const char *name, const std::vector<T> &values, const CES::ByteBuffer &encoded) {
+        std::vector<T> destination;
+        const double read = best_mvps([&] { CES::BinaryConverter::deserialize(destination, encoded.span()); });
+        std::printf("%-16s %9.1f M/s %12zu B %7.2f bits/value%s\n", name, read, encoded.size(),
+                    static_cast<double>(encoded.size()) * 8 / elements, destination == values ? "" : " (mismatch)");
+    }
+}
+
+void run_series_bench() {
+    std::mt19937_64 random(42);
+    std::vector<long long> timestamps(elements);
+    std::vector<double> readings(elements);
+    double reading = 21.5;
+    for (std::size_t i = 0; i < elements; ++i) {
+        timestamps[i] = 1'790'000'000'000 + static_cast<long long>(i) * 1000 + static_cast<long long>(random() % 4);
+        reading += static_cast<double>(static_cast<int>(random() % 5) - 2) / 100.0;
+        readings[i] = reading;
+    }
+
+    CES::ByteBuffer native, deltas, deltas_of_deltas, native_readings, xors;
+    CES::BinaryConverter::serialize(timestamps, native);
+    CES::BinaryConverter::serialize(CES::delta(timestamps), deltas);
+    CES::BinaryConverter::serialize(CES::delta_of_delta(timestamps), deltas_of_deltas);
+    CES::BinaryConverter::serialize(readings, native_readings);
+    CES::BinaryConverter::serialize(CES::xor_floats(readings), xors);
+
+    std::printf("Timestamps (ms, 1 s apart with jitter) and readings, %zu elements\n", elements);
+    report("LONG LONG ARRAY", timestamps, native);
+    report("DELTA", timestamps, deltas);
+    report("DELTA OF DELTA", timestamps, deltas_of_deltas);
+    report("DOUBLE ARRAY", readings, native_readings);
+    report("XOR FLOAT", readings, xors);
+}
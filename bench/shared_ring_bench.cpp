@@ -0,0 +1,115 @@
+/**
+ * @file shared_ring_bench.cpp
+ * @brief Measures the latency of passing a value through a shared ring against passing it through a file.
+ * @details The file path is the one of main.cpp: serialize into a file, close it, open it again and deserialize. The
+ * ring is measured twice, written and read by the same thread, and as a round trip between two processes where the
+ * child reads every value from one ring and writes it back into another. The value is a DOUBLE_ARRAY of 64 elements.
+ * Latencies are in ns per exchange.
+ * @copyright CES Public License
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Bench.hpp"
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../inc/SharedRing.hpp"
+#else
+#include "../inc/BinaryConverter.hpp"
+#endif
+
+namespace {
+    constexpr std::size_t elements = 64;
+    constexpr std::size_t file_exchanges = 2000;
+    constexpr std::size_t ring_exchanges = 20000;
+
+    /*
+     * Times every run of an exchange.
+     */
+    template<typename F>
+    std::vector<double> sample(std::size_t count, F &&exchange) {
+        std::vector<double> samples(count);
+        for (double &ns: samples) {
+            const auto start = std::chrono::steady_clock::now();
+            exchange();
+            ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        }
+        return samples;
+    }
+
+    void print(const char *name, std::vector<double> samples) {
+        std::sort(samples.begin(), samples.end());
+        const auto at = [&](double fraction) { return samples[static_cast<std::size_t>(fraction * static_cast<double>(samples.size() - 1))]; };
+        std::printf("%-28s %10.0f %10.0f %10.0f\n", name, at(0.5), at(0.99), at(0.999));
+    }
+}
+
+void run_shared_ring_bench() {
+    std::vector<double> values(elements), destination;
+    for (std::size_t i = 0; i < elements; ++i) values[i] = static_cast<double>(i) / 3;
+
+    std::printf("DOUBLE_ARRAY of %zu elements, ns per exchange\n", elements);
+    std::printf("%-28s %10s %10s %10s\n", "path", "p50", "p99", "p99.9");
+
+    const std::string path = (std::filesystem::temp_directory_path() / "ces_ring_bench.bin").string();
+    print("file, same process", sample(file_exchanges, [&] {
+        std::ofstream ostream(path, std::ios::binary);
+        CES::BinaryConverter::serialize(values, ostream);
+        ostream.close();
+        std::ifstream istream(path, std::ios::binary);
+        CES::BinaryConverter::deserialize(destination, istream);
+    }));
+    std::filesystem::remove(path);
+
+#ifndef _WIN32
+    const std::string requests = "ces_ring_bench_" + std::to_string(getpid());
+    const std::string replies = requests + "_replies";
+    {
+        CES::SharedRingWriter writer(requests, 1 << 16);
+        CES::SharedRingReader reader(requests);
+        print("ring, same process", sample(ring_exchanges, [&] {
+            writer.write(values);
+            reader.next();
+            reader.read(destination);
+        }));
+    }
+
+    CES::SharedRingWriter writer(requests, 1 << 16);
+    CES::SharedRingWriter replier(replies, 1 << 16);
+    const pid_t child = fork();
+    if (child == 0) { // echoes every value back.
+        int status = 1;
+        try {
+            CES::SharedRingReader reader(requests);
+            std::vector<double> echo;
+            while (reader.next()) {
+                reader.read(echo);
+                replier.write(echo);
+            }
+            status = 0;
+        } catch (...) {
+        }
+        _exit(status);
+    }
+    if (child < 0) {
+        std::printf("%-28s could not fork\n", "ring, round trip");
+        return;
+    }
+    CES::SharedRingReader reader(replies);
+    print("ring, round trip", sample(ring_exchanges, [&] {
+        writer.write(values);
+        reader.next();
+        reader.read(destination);
+    }));
+    writer.close();
+    waitpid(child, nullptr, 0);
+#else
+    std::printf("%-28s not available on this system\n", "ring");
+#endif
+}
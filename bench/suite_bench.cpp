@@ -0,0 +1,401 @@
+/**
+ * @file suite_bench.cpp
+ * @brief The benchmark matrix: every type flag, written and read through the buffer and the stream backends.
+ * @details Each type flag is measured at sizes from one element up to the --max-bytes limit, through a ByteBuffer
+ * and through a std::stringstream, and read back from bytes written on this system and, where the bytes can be
+ * converted, from bytes as a system with the other byte order writes them. Every measurement is calibrated to a
+ * batch of about a tenth of --min-time, repeated for at least --min-time and 5 batches, and the median batch is
+ * reported. The values are generated from a fixed seed, so two runs measure the same bytes.
+ *
+ * The allocations are counted by replacing the global operator new and new[] of the bench executable. The counter is a
+ * relaxed atomic increment, the other benchmarks do not notice it.
+ * @copyright CES Public License
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../inc/Columns.hpp"
+#include "Bench.hpp"
+
+namespace {
+    std::atomic<std::size_t> allocations{0};
+}
+
+void *operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size != 0 ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) { return ::operator new(size); }
+
+// kept out of line: inlined into the allocators, the free looks to GCC like it releases memory of the builtin new.
+[[gnu::noinline]] void operator delete(void *p) noexcept { std::free(p); }
+
+[[gnu::noinline]] void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+void operator delete[](void *p) noexcept { ::operator delete(p); }
+
+void operator delete[](void *p, std::size_t size) noexcept { ::operator delete(p, size); }
+
+namespace {
+#ifdef __VERSION__
+    constexpr const char *compiler = __VERSION__;
+#else
+    constexpr const char *compiler = "unknown";
+#endif
+
+    struct Quote {
+        long time;
+        double bid;
+        double ask;
+        int size;
+        int venue;
+        CES_FIELDS(time, bid, ask, size, venue)
+    };
+
+    struct Result {
+        std::string tag;
+        std::size_t elements;
+        std::size_t bytes;
+        const char *backend;
+        const char *endian;
+        const char *op;
+        double ns_per_op;
+        double mb_per_s;
+        double allocs_per_op;
+    };
+
+    struct Measurement {
+        double ns_per_op;
+        double allocs_per_op;
+    };
+
+    /*
+     * Median time per call of op, and the allocations per call.
+     */
+    template<typename F>
+    Measurement measure(double min_time, F &&op) {
+        using clock = std::chrono::steady_clock;
+        op(); // sizes the buffers, the steady state is measured.
+        const auto time = [&](std::size_t n) {
+            const auto start = clock::now();
+            for (std::size_t i = 0; i < n; ++i) op();
+            return std::chrono::duration<double>(clock::now() - start).count();
+        };
+        std::size_t batch = 1;
+        while (time(batch) < min_time / 10 && batch < (std::size_t{1} << 30)) batch *= 2;
+
+        std::vector<double> samples;
+        const std::size_t allocated = allocations.load(std::memory_order_relaxed);
+        const auto start = clock::now();
+        do {
+            samples.push_back(time(batch) / static_cast<double>(batch));
+        } while (samples.size() < 5 || std::chrono::duration<double>(clock::now() - start).count() < min_time);
+        const double calls = static_cast<double>(samples.size() * batch);
+        const double allocs = static_cast<double>(allocations.load(std::memory_order_relaxed) - allocated) / calls;
+        std::nth_element(samples.begin(), samples.begin() + static_cast<long>(samples.size() / 2), samples.end());
+        return {samples[samples.size() / 2] * 1e9, allocs};
+    }
+
+    /*
+     * Rewrites one serialized value the way a system with the other byte order writes it.
+     * @return false for the type flags whose payload is not converted here (STRUCT and COLUMNS).
+     */
+    bool to_foreign(std::vector<std::byte> &bytes) {
+        const auto t = static_cast<type>(bytes[1]);
+        if (t == STRUCT || t == COLUMNS) return false;
+        bytes[0] = static_cast<std::byte>(static_cast<unsigned char>(bytes[0]) ^ 1); // LE <-> BE.
+        std::byte *position = bytes.data() + 2;
+        const auto reverse = [&](std::size_t width) {
+            std::reverse(position, position + width);
+            position += width;
+        };
+        const auto length = [&] {
+            std::size_t size;
+            std::memcpy(&size, position, sizeof(size));
+            reverse(sizeof(size));
+            return size;
+        };
+        if (is_varint(t)) return true; // varints have no byte order.
+        if (is_series(t)) { // the series is little endian everywhere, only the count and the byte length are native.
+            length();
+            position += 1;
+            length();
+        } else if (t == ZONED_ARRAY) {
+            const std::size_t count = length();
+            const auto plain = static_cast<type>(*position++);
+            const std::size_t block = length(), width = element_size(plain);
+            for (std::size_t zone = 0; zone * block < count; ++zone) {
+                reverse(width); // the minimum, the maximum and the count, then the flag byte.
+                reverse(width);
+                reverse(sizeof(std::uint32_t));
+                position += 1;
+            }
+            for (std::size_t i = 0; i < count; ++i) reverse(width);
+        } else if (t == DICTIONARY_STRING_ARRAY) {
+            const std::size_t count = length(), unique = length();
+            const auto width = static_cast<std::size_t>(*position++);
+            for (std::size_t i = 0; i < unique; ++i) position += length();
+            for (std::size_t i = 0; i < count; ++i) reverse(width);
+        } else if (t == STRING_ARRAY) {
+            for (std::size_t i = 0, count = length(); i < count; ++i) position += length();
+        } else if (t == PACKED_BOOL_ARRAY || t == STRING || t >= INT_ARRAY) {
+            const std::size_t count = length();
+            for (std::size_t i = 0; i < count && t != PACKED_BOOL_ARRAY; ++i) reverse(element_size(t));
+        } else {
+            reverse(element_size(t));
+        }
+        return true;
+    }
+
+    class Suite {
+        const SuiteOptions &options;
+        std::vector<Result> results;
+        std::mt19937_64 random{20261017};
+
+        void add(const std::string &tag, std::size_t elements, std::size_t bytes, const char *backend, const char *endian,
+                 const char *op, const Measurement &measured) {
+            const Result result{tag, elements, bytes, backend, endian, op, measured.ns_per_op,
+                                static_cast<double>(bytes) / measured.ns_per_op * 1e3, measured.allocs_per_op};
+            std::printf("%-26s %10zu %12zu %-7s %-8s %-6s %12.1f %10.1f %9.2f\n", tag.c_str(), elements, bytes, backend, endian,
+                        op, result.ns_per_op, result.mb_per_s, result.allocs_per_op);
+            std::fflush(stdout);
+            results.push_back(result);
+        }
+
+        /*
+         * Writes and reads one value through both backends.
+         * @param value what is serialized, a plain value or an encoding wrapper.
+         * @param destination what it is deserialized into.
+         */
+        template<typename Value, typename Destination>
+        void run(std::size_t elements, const Value &value, Destination &destination) {
+            constexpr type t = type_tag_v<Value>;
+            const std::string tag = type_name(t);
+            if (!options.filter.empty() && tag.find(options.filter) == std::string::npos) return;
+            const std::size_t bytes = CES::BinaryConverter::size_of(value);
+
+            CES::ByteBuffer buffer;
+            add(tag, elements, bytes, "buffer", "same", "write", measure(options.min_time, [&] {
+                buffer.clear();
+                CES::BinaryConverter::serialize(value, buffer);
+            }));
+            std::vector<std::byte> same(buffer.data(), buffer.data() + buffer.size());
+            std::vector<std::byte> foreign = same;
+            const bool cross = to_foreign(foreign);
+
+            const auto read_bytes = [&](const std::vector<std::byte> &from) {
+                if constexpr (t == COLUMNS) CES::ColumnReader(from).read_records(destination);
+                else CES::BinaryConverter::deserialize(destination, std::span<const std::byte>(from));
+            };
+            add(tag, elements, bytes, "buffer", "same", "read", measure(options.min_time, [&] { read_bytes(same); }));
+            if (cross) add(tag, elements, bytes, "buffer", "cross", "read", measure(options.min_time, [&] { read_bytes(foreign); }));
+
+            std::stringstream ostream;
+            add(tag, elements, bytes, "stream", "same", "write", measure(options.min_time, [&] {
+                ostream.seekp(0);
+                CES::BinaryConverter::serialize(value, ostream);
+            }));
+            if constexpr (t != COLUMNS) { // COLUMNS values are read from memory only, by the ColumnReader.
+                const auto read_stream = [&](const std::vector<std::byte> &from, const char *endian) {
+                    std::istringstream istream(std::string(reinterpret_cast<const char *>(from.data()), from.size()));
+                    add(tag, elements, bytes, "stream", endian, "read", measure(options.min_time, [&] {
+                        istream.clear();
+                        istream.seekg(0);
+                        CES::BinaryConverter::deserialize(destination, istream);
+                    }));
+                };
+                read_stream(same, "same");
+                if (cross) read_stream(foreign, "cross");
+            }
+        }
+
+        /*
+         * The array sizes that stay below the byte limit: 1, 1 Ki, 1 Mi and 128 Mi elements.
+         */
+        [[nodiscard]] std::vector<std::size_t> sizes(std::size_t element_bytes) const {
+            std::vector<std::size_t> counts;
+            for (const std::size_t count: {std::size_t{1}, std::size_t{1} << 10, std::size_t{1} << 20, std::size_t{1} << 27}) {
+                if (count * element_bytes <= options.max_bytes) counts.push_back(count);
+            }
+            return counts;
+        }
+
+        template<typename T>
+        T value() {
+            if constexpr (std::is_same_v<T, bool>) return random() & 1;
+            else return static_cast<T>(random() % 1000);
+        }
+
+        template<typename T>
+        void scalar() {
+            const T v = value<T>();
+            T destination{};
+            run(1, v, destination);
+        }
+
+        template<typename T>
+        void array() {
+            for (const std::size_t count: sizes(sizeof(T))) {
+                std::vector<T> values(count);
+                for (std::size_t i = 0; i < count; ++i) values[i] = value<T>();
+                std::vector<T> destination;
+                run(count, values, destination);
+            }
+        }
+
+    public:
+
+        explicit Suite(const SuiteOptions &options) : options(options) {}
+
+        void run_all() {
+            std::printf("%-26s %10s %12s %-7s %-8s %-6s %12s %10s %9s\n", "type", "elements", "bytes", "backend", "endian",
+                        "op", "ns/op", "MB/s", "allocs/op");
+            scalar<int>();
+            scalar<unsigned int>();
+            scalar<short>();
+            scalar<unsigned short>();
+            scalar<long>();
+            scalar<unsigned long>();
+            scalar<long long>();
+            scalar<unsigned long long>();
+            scalar<float>();
+            scalar<double>();
+            scalar<long double>();
+            scalar<char>();
+            scalar<unsigned char>();
+            scalar<bool>();
+            for (const std::size_t count: sizes(1)) {
+                std::string text(count, ' ');
+                for (char &c: text) c = static_cast<char>('a' + random() % 26);
+                std::string destination;
+                run(count, text, destination);
+            }
+
+            array<int>();
+            array<unsigned int>();
+            array<short>();
+            array<unsigned short>();
+            array<long>();
+            array<unsigned long>();
+            array<long long>();
+            array<unsigned long long>();
+            array<float>();
+            array<double>();
+            array<long double>();
+            for (const std::size_t count: sizes(24 + sizeof(std::size_t))) {
+                std::vector<std::string> strings(count);
+                for (std::string &s: strings) s = "string value " + std::to_string(random() % 100000000000ULL);
+                std::vector<std::string> destination;
+                run(count, strings, destination);
+                for (std::string &s: strings) s = "host-" + std::to_string(random() % 64) + ".example.com";
+                run(count, CES::dictionary(strings), destination);
+            }
+            array<char>();
+            array<unsigned char>();
+            array<bool>();
+
+            for (const std::size_t count: sizes(1)) {
+                std::vector<bool> flags(count);
+                for (std::size_t i = 0; i < count; ++i) flags[i] = random() & 1;
+                std::vector<bool> destination;
+                run(count, CES::packed(flags), destination);
+            }
+            {
+                const unsigned long long unsigned_value = value<unsigned long long>();
+                const long long signed_value = -value<long long>();
+                unsigned long long unsigned_destination;
+                long long signed_destination;
+                run(1, CES::varint(unsigned_value), unsigned_destination);
+                run(1, CES::varint(signed_value), signed_destination);
+            }
+            for (const std::size_t count: sizes(sizeof(long long))) {
+                std::vector<unsigned long long> unsigned_values(count);
+                std::vector<long long> signed_values(count);
+                for (std::size_t i = 0; i < count; ++i) {
+                    unsigned_values[i] = value<unsigned long long>();
+                    signed_values[i] = static_cast<long long>(unsigned_values[i]) - 500;
+                }
+                std::vector<unsigned long long> unsigned_destination;
+                std::vector<long long> signed_destination;
+                run(count, CES::varint(unsigned_values), unsigned_destination);
+                run(count, CES::varint(signed_values), signed_destination);
+            }
+
+            for (const std::size_t count: sizes(sizeof(long long))) {
+                std::vector<long long> timestamps(count);
+                std::vector<double> readings(count);
+                for (std::size_t i = 0; i < count; ++i) {
+                    timestamps[i] = 1'790'000'000'000 + static_cast<long long>(i) * 1000 + static_cast<long long>(random() % 3);
+                    readings[i] = 20.0 + static_cast<double>(value<int>()) / 100.0;
+                }
+                std::vector<long long> timestamp_destination;
+                std::vector<double> reading_destination;
+                run(count, CES::delta(timestamps), timestamp_destination);
+                run(count, CES::delta_of_delta(timestamps), timestamp_destination);
+                run(count, CES::xor_floats(readings), reading_destination);
+                run(count, CES::zone_map(readings), reading_destination);
+            }
+
+            const Quote quote{value<long>(), 1.5, 2.5, value<int>(), 3};
+            Quote quote_destination{};
+            run(1, quote, quote_destination);
+            for (const std::size_t count: sizes(sizeof(Quote))) {
+                std::vector<Quote> quotes(count);
+                for (std::size_t i = 0; i < count; ++i) quotes[i] = {static_cast<long>(i), 1.5, 2.5, value<int>(), 3};
+                std::vector<Quote> destination;
+                run(count, CES::columnar(quotes), destination);
+            }
+        }
+
+        void write_csv(const std::string &path) const {
+            std::FILE *file = std::fopen(path.c_str(), "w");
+            if (!file) throw std::runtime_error("Could not open " + path);
+            std::fprintf(file, "type,elements,bytes,backend,endian,op,ns_per_op,mb_per_s,allocs_per_op\n");
+            for (const Result &r: results) {
+                std::fprintf(file, "%s,%zu,%zu,%s,%s,%s,%.3f,%.3f,%.4f\n", r.tag.c_str(), r.elements, r.bytes, r.backend,
+                             r.endian, r.op, r.ns_per_op, r.mb_per_s, r.allocs_per_op);
+            }
+            std::fclose(file);
+        }
+
+        void write_json(const std::string &path) const {
+            std::FILE *file = std::fopen(path.c_str(), "w");
+            if (!file) throw std::runtime_error("Could not open " + path);
+            const std::time_t now = std::time(nullptr);
+            char date[32];
+            std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+            std::fprintf(file, "{\n  \"format\": 1,\n  \"library_version\": \"1.0\",\n  \"compiler\": \"%s\",\n", compiler);
+            std::fprintf(file, "  \"date\": \"%s\",\n  \"max_bytes\": %zu,\n  \"min_time\": %g,\n  \"results\": [\n", date,
+                         options.max_bytes, options.min_time);
+            for (std::size_t i = 0; i < results.size(); ++i) {
+                const Result &r = results[i];
+                std::fprintf(file, "    {\"type\": \"%s\", \"elements\": %zu, \"bytes\": %zu, \"backend\": \"%s\", \"endian\": \"%s\", "
+                                   "\"op\": \"%s\", \"ns_per_op\": %.3f, \"mb_per_s\": %.3f, \"allocs_per_op\": %.4f}%s\n",
+                             r.tag.c_str(), r.elements, r.bytes, r.backend, r.endian, r.op, r.ns_per_op, r.mb_per_s,
+                             r.allocs_per_op, i + 1 < results.size() ? "," : "");
+            }
+            std::fprintf(file, "  ]\n}\n");
+            std::fclose(file);
+        }
+    };
+}
+
+void run_suite_bench(const SuiteOptions &options) {
+    Suite suite(options);
+    suite.run_all();
+    if (!options.csv.empty()) suite.write_csv(options.csv);
+    if (!options.json.empty()) suite.write_json(options.json);
+}
@@ -0,0 +1,54 @@
+/**
+ * @file varint_bench.cpp
+ * @brief Measures the size and the decode speed of the varint encoding against native LONG_ARRAY payloads.
+ * @details The data are small counters with an occasional large value, the case the compact mode is made for.
+ * Both encodings are decoded from memory, so the numbers show the decoding cost; on storage that delivers fewer
+ * bytes per second than the decoder consumes, the smaller payload is what decides the throughput.
+ * @copyright CES Public License
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "../inc/BinaryConverter.hpp"
+#include "Bench.hpp"
+
+namespace {
+    constexpr std::size_t elements = 1 << 22;
+    constexpr int repetitions = 10;
+
+    /*
+     * Best decode rate in millions of values per second.
+     */
+    template<typename F>
+    double best_mvps(F &&run) {
+        double best = 0;
+        for (int r = 0; r < repetitions; ++r) {
+            const auto start = std::chrono::steady_clock::now();
+            run();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::max(best, elements / elapsed.count() / 1e6);
+        }
+        return best;
+    }
+}
+
+void run_varint_bench() {
+    std::mt19937_64 random(42);
+    std::vector<long> counters(elements);
+    for (long &counter: counters) counter = random() % 64 == 0 ? static_cast<long>(random() % 1000000) : static_cast<long>(random() % 100);
+
+    CES::ByteBuffer native, compact;
+    CES::BinaryConverter::serialize(counters, native);
+    CES::BinaryConverter::serialize(CES::varint(counters), compact);
+
+    std::vector<long> destination;
+    const double native_read = best_mvps([&] { CES::BinaryConverter::deserialize(destination, native.span()); });
+    const double compact_read = best_mvps([&] { CES::BinaryConverter::deserialize(destination, compact.span()); });
+
+    std::printf("LONG_ARRAY of small counters, %zu elements%s\n", elements, destination == counters ? "" : " (mismatch)");
+    std::printf("%-14s %14s %14s\n", "", "native", "varint");
+    std::printf("%-14s %9.1f M/s %9.1f M/s\n", "read", native_read, compact_read);
+    std::printf("%-14s %11zu B %12zu B\n", "size", native.size(), compact.size());
+}
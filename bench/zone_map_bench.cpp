@@ -0,0 +1,88 @@
+/**
+ * @file zone_map_bench.cpp
+ * @brief Measures range scans over a ZONED_ARRAY against deserializing the plain array and filtering it.
+ * @details Timestamps one millisecond apart with jitter, which the zones cluster well, are queried for ranges that
+ * hold from 0.01% to all of them, and uniformly random prices, which no zone can rule out, for 1% of them. The zoned
+ * scans run from memory and from a stringstream, the baseline deserializes the LONG_LONG_ARRAY or DOUBLE_ARRAY from
+ * memory and compares every element. Times are in ms per query, best of the repetitions.
+ * @copyright CES Public License
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <vector>
+#include "../inc/ZoneMap.hpp"
+#include "Bench.hpp"
+
+namespace {
+    constexpr std::size_t elements = 1 << 22;
+    constexpr int repetitions = 10;
+
+    template<typename F>
+    double best_ms(F &&run) {
+        double best = 1e300;
+        for (int r = 0; r < repetitions; ++r) {
+            const auto start = std::chrono::steady_clock::now();
+            run();
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+
+    /*
+     * Prints one query: the plain baseline, the zoned scans from memory and from a stream, and the share of the
+     * blocks the zones let through.
+     */
+    template<typename T>
+    void query(const char *name, const std::vector<T> &values, T low, T high) {
+        CES::ByteBuffer plain, zoned;
+        CES::BinaryConverter::serialize(values, plain);
+        CES::BinaryConverter::serialize(CES::zone_map(values), zoned);
+        const std::span<const std::byte> plain_bytes(plain.data(), plain.size()), zoned_bytes(zoned.data(), zoned.size());
+        std::stringstream stream;
+        CES::BinaryConverter::serialize(CES::zone_map(values), stream);
+
+        std::vector<T> destination;
+        std::size_t expected = 0, memory = 0, streamed = 0;
+        const double baseline = best_ms([&] {
+            CES::BinaryConverter::deserialize(destination, plain_bytes);
+            expected = static_cast<std::size_t>(std::count_if(destination.begin(), destination.end(), [&](T value) { return value >= low && value <= high; }));
+        });
+        double sum = 0;
+        const double from_memory = best_ms([&] {
+            const auto array = CES::ZonedArray<T>::from(zoned_bytes);
+            memory = array.scan(low, high, [&](std::size_t, T value) { sum += static_cast<double>(value); });
+        });
+        const double from_stream = best_ms([&] {
+            stream.clear();
+            stream.seekg(0);
+            const auto array = CES::ZonedArray<T>::from(stream);
+            streamed = array.scan(low, high, [&](std::size_t, T value) { sum += static_cast<double>(value); });
+        });
+        const auto array = CES::ZonedArray<T>::from(zoned_bytes);
+        const double blocks = 100.0 * static_cast<double>(array.candidate_blocks(low, high)) / static_cast<double>(array.zones().size());
+        std::printf("%-22s %9.3f%% %9.1f%% %10.3f %10.3f %10.3f%s\n", name, 100.0 * static_cast<double>(expected) / elements, blocks,
+                    baseline, from_memory, from_stream, memory == expected && streamed == expected ? "" : " (mismatch)");
+    }
+}
+
+void run_zone_map_bench() {
+    std::mt19937_64 random(42);
+    std::vector<long long> timestamps(elements);
+    std::vector<double> prices(elements);
+    for (std::size_t i = 0; i < elements; ++i) {
+        timestamps[i] = 1'790'000'000'000 + static_cast<long long>(i) + static_cast<long long>(random() % 20);
+        prices[i] = static_cast<double>(random() % 1'000'000) / 100.0;
+    }
+    const long long start = timestamps.front(), n = static_cast<long long>(elements);
+
+    std::printf("%zu elements, zones of 4096, ms per query (AVX2 %s)\n", elements, CES::CpuFeatures::has_avx2() ? "on" : "off");
+    std::printf("%-22s %10s %10s %10s %10s %10s\n", "query", "matches", "blocks", "plain", "memory", "stream");
+    query("timestamps 0.01%", timestamps, start + 1'000'000, start + 1'000'000 + n / 10'000);
+    query("timestamps 1%", timestamps, start + 1'000'000, start + 1'000'000 + n / 100);
+    query("timestamps 10%", timestamps, start + 1'000'000, start + 1'000'000 + n / 10);
+    query("timestamps 100%", timestamps, start - 100, start + 2 * n);
+    query("prices 1%", prices, 5000.0, 5100.0);
+}
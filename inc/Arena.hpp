@@ -0,0 +1,139 @@
+#ifndef BINARY_DATA_PROCESSING_ARENA_HPP
+#define BINARY_DATA_PROCESSING_ARENA_HPP
+
+/**
+ * @file Arena.hpp
+ * @brief Contains the Arena class, a monotonic memory resource for deserializing messages without heap allocations.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details Objects that use std::pmr::polymorphic_allocator (std::pmr::string, std::pmr::vector and containers of
+ * them) draw their memory from the arena by bumping a pointer, deallocation does nothing and reset() frees
+ * everything at once. Unlike std::pmr::monotonic_buffer_resource the blocks are kept by reset(), and when a message
+ * needed more than one block they are merged into a single one, so after the first few messages decoding one does
+ * not touch the heap at all. Use it with BinaryConverter::deserialize<T>(bytes, &arena).
+ * @copyright CES Public License
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace CES {
+    class Arena : public std::pmr::memory_resource {
+        struct Block {
+            std::byte *data;
+            std::size_t size;
+        };
+
+        std::pmr::memory_resource *upstream;
+        std::size_t block_size;
+        std::vector<Block> blocks;
+        std::size_t current = 0; // the block being filled.
+        std::byte *position = nullptr;
+        std::byte *end = nullptr;
+        std::size_t handed_out = 0;
+
+        static constexpr std::size_t block_alignment = alignof(std::max_align_t);
+
+        void release() {
+            for (const Block &block: blocks) upstream->deallocate(block.data, block.size, block_alignment);
+            blocks.clear();
+            current = 0;
+            position = end = nullptr;
+        }
+
+        /*
+         * Moves to the next block that holds at least size bytes, a larger one is allocated when none does.
+         */
+        void next_block(std::size_t size) {
+            while (!blocks.empty() && current + 1 < blocks.size()) {
+                const Block &block = blocks[++current];
+                if (block.size >= size) {
+                    position = block.data;
+                    end = block.data + block.size;
+                    return;
+                }
+            }
+            const std::size_t grown = blocks.empty() ? block_size : blocks.back().size * 2;
+            const Block block{static_cast<std::byte *>(upstream->allocate(std::max(grown, size), block_alignment)), std::max(grown, size)};
+            blocks.push_back(block);
+            current = blocks.size() - 1;
+            position = block.data;
+            end = block.data + block.size;
+        }
+
+    protected:
+
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+            auto aligned = [&] {
+                const auto address = reinterpret_cast<std::uintptr_t>(position);
+                return position + ((alignment - address % alignment) % alignment);
+            };
+            std::byte *start = position ? aligned() : nullptr;
+            if (!start || start > end || static_cast<std::size_t>(end - start) < bytes) {
+                next_block(bytes + alignment);
+                start = aligned();
+            }
+            position = start + bytes;
+            handed_out += bytes;
+            return start;
+        }
+
+        void do_deallocate(void *, std::size_t, std::size_t) override {} // freed by reset().
+
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+    public:
+
+        /*
+         * Creates an empty arena, the first block is allocated with the first allocation.
+         * @param block_size the size of the first block, the following ones double.
+         * @param upstream where the blocks come from.
+         */
+        explicit Arena(std::size_t block_size = 64 * 1024, std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+                : upstream(upstream), block_size(std::max<std::size_t>(block_size, 64)) {}
+
+        ~Arena() override { release(); }
+
+        Arena(const Arena &) = delete;
+        Arena &operator=(const Arena &) = delete;
+
+        /*
+         * Frees everything allocated from the arena at once. The objects using it must not be used afterwards (a
+         * pmr container may still be destroyed, its deallocations are ignored). The blocks are kept, several
+         * blocks are merged into one so that the next round fits in a single block.
+         */
+        void reset() {
+            if (blocks.size() > 1) {
+                std::size_t total = 0;
+                for (const Block &block: blocks) total += block.size;
+                release();
+                blocks.push_back({static_cast<std::byte *>(upstream->allocate(total, block_alignment)), total});
+            }
+            current = 0;
+            position = blocks.empty() ? nullptr : blocks[0].data;
+            end = blocks.empty() ? nullptr : blocks[0].data + blocks[0].size;
+            handed_out = 0;
+        }
+
+        /*
+         * The number of bytes handed out since the last reset.
+         */
+        [[nodiscard]] std::size_t used() const { return handed_out; }
+
+        /*
+         * The number of bytes held in blocks.
+         */
+        [[nodiscard]] std::size_t capacity() const {
+            std::size_t total = 0;
+            for (const Block &block: blocks) total += block.size;
+            return total;
+        }
+
+        [[nodiscard]] std::size_t block_count() const { return blocks.size(); }
+    };
+}
+#endif //BINARY_DATA_PROCESSING_ARENA_HPP
@@ -0,0 +1,702 @@
+#ifndef BINARY_DATA_PROCESSING_ASYNCIO_HPP
+#define BINARY_DATA_PROCESSING_ASYNCIO_HPP
+
+/**
+ * @file AsyncIO.hpp
+ * @brief Contains the AsyncReader and AsyncWriter classes, double buffered file I/O that overlaps with decoding and
+ * encoding.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details Both classes own two buffers of a fixed size. The reader decodes values out of one buffer while the next
+ * block of the file is read into the other, the writer encodes values into one buffer while the other is written.
+ * The file format is the one of BinaryConverter::serialize, a file written with an ostream reads back with the
+ * AsyncReader and the other way around. Besides the blocking reads, the reader hands blocks or values to a callback
+ * (for_each_block, for_each), and block_ready() tells without blocking whether the next block has arrived, for event
+ * loops and coroutines that want to do other work meanwhile.
+ *
+ * On Linux the reads and writes go through io_uring, talked to with the raw system calls so there is no library to
+ * link. Kernels without io_uring (or with it disabled) and other systems get a background thread that does the
+ * positioned reads and writes instead, the behaviour is the same.
+ * @copyright CES Public License
+ */
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include "BinaryConverter.hpp"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define CES_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace CES {
+    /*
+     * A file with a fixed number of slots, each slot has at most one read or write in flight. Used by the
+     * AsyncReader and the AsyncWriter, one slot per buffer.
+     */
+    class AsyncFile {
+        struct Request {
+            std::byte *buffer = nullptr;
+            std::size_t size = 0;
+            std::uint64_t offset = 0;
+            bool write = false;
+            bool pending = false;
+            bool done = false; // the last part submitted completed.
+            long long result = 0; // bytes transferred, or -errno.
+            std::size_t transferred = 0; // by the parts that completed before.
+            bool complete = false; // every part completed, wait(slot) returns without blocking.
+        };
+
+        static constexpr unsigned max_slots = 8;
+
+        Request requests[max_slots];
+        unsigned slot_count;
+#ifdef _WIN32
+        HANDLE handle = INVALID_HANDLE_VALUE;
+#else
+        int fd = -1;
+#endif
+
+        // the thread backend.
+        std::thread worker;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+        std::deque<unsigned> queue;
+        bool stopping = false;
+
+#ifdef CES_IO_URING
+        struct Ring {
+            int fd = -1;
+            void *sq_ring = nullptr;
+            void *cq_ring = nullptr;
+            std::size_t sq_ring_size = 0;
+            std::size_t cq_ring_size = 0;
+            io_uring_sqe *sqes = nullptr;
+            std::size_t sqes_size = 0;
+            unsigned *sq_tail = nullptr;
+            unsigned *sq_mask = nullptr;
+            unsigned *sq_array = nullptr;
+            unsigned *cq_head = nullptr;
+            unsigned *cq_tail = nullptr;
+            unsigned *cq_mask = nullptr;
+            io_uring_cqe *cqes = nullptr;
+        } ring;
+
+        /*
+         * Sets up a ring with room for every slot. IORING_OP_READ and IORING_OP_WRITE need Linux 5.6, the fast poll
+         * feature arrived with 5.7 and tells that they are there.
+         * @return false when the kernel does not offer io_uring to this process.
+         */
+        bool setup_ring() {
+            io_uring_params params{};
+            const long ring_fd = syscall(__NR_io_uring_setup, max_slots, &params);
+            if (ring_fd < 0) return false;
+            ring.fd = static_cast<int>(ring_fd);
+            if (!(params.features & IORING_FEAT_FAST_POLL)) {
+                close_ring();
+                return false;
+            }
+            ring.sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            ring.cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+            if (single) ring.sq_ring_size = ring.cq_ring_size = std::max(ring.sq_ring_size, ring.cq_ring_size);
+
+            ring.sq_ring = mmap(nullptr, ring.sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_SQ_RING);
+            if (ring.sq_ring == MAP_FAILED) ring.sq_ring = nullptr;
+            ring.cq_ring = single ? ring.sq_ring : mmap(nullptr, ring.cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_CQ_RING);
+            if (ring.cq_ring == MAP_FAILED) ring.cq_ring = nullptr;
+            ring.sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+            void *sqes = mmap(nullptr, ring.sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_SQES);
+            ring.sqes = sqes == MAP_FAILED ? nullptr : static_cast<io_uring_sqe *>(sqes);
+            if (!ring.sq_ring || !ring.cq_ring || !ring.sqes) {
+                close_ring();
+                return false;
+            }
+
+            auto *sq = static_cast<unsigned char *>(ring.sq_ring);
+            auto *cq = static_cast<unsigned char *>(ring.cq_ring);
+            ring.sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+            ring.sq_mask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+            ring.sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+            ring.cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+            ring.cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+            ring.cq_mask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+            ring.cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+            return true;
+        }
+
+        void close_ring() {
+            if (ring.sqes) munmap(ring.sqes, ring.sqes_size);
+            if (ring.cq_ring && ring.cq_ring != ring.sq_ring) munmap(ring.cq_ring, ring.cq_ring_size);
+            if (ring.sq_ring) munmap(ring.sq_ring, ring.sq_ring_size);
+            if (ring.fd >= 0) ::close(ring.fd);
+            ring = Ring{};
+        }
+
+        int enter(unsigned submit, unsigned wait) {
+            while (true) {
+                const long result = syscall(__NR_io_uring_enter, ring.fd, submit, wait, wait ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+                if (result >= 0 || errno != EINTR) return static_cast<int>(result);
+            }
+        }
+
+        void submit_ring(unsigned slot) {
+            const Request &request = requests[slot];
+            const unsigned tail = *ring.sq_tail; // only this thread writes the tail.
+            const unsigned index = tail & *ring.sq_mask;
+            io_uring_sqe &sqe = ring.sqes[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = request.write ? IORING_OP_WRITE : IORING_OP_READ;
+            sqe.fd = fd;
+            sqe.addr = reinterpret_cast<std::uint64_t>(request.buffer);
+            sqe.len = static_cast<std::uint32_t>(request.size);
+            sqe.off = request.offset;
+            sqe.user_data = slot;
+            ring.sq_array[index] = index;
+            __atomic_store_n(ring.sq_tail, tail + 1, __ATOMIC_RELEASE);
+            if (enter(1, 0) < 0) throw std::runtime_error("io_uring submission failed");
+        }
+
+        /*
+         * Takes the completions that are already on the ring off it, without waiting.
+         * @return false when there were none.
+         */
+        bool drain_ring() {
+            bool reaped = false;
+            for (unsigned head = *ring.cq_head; head != __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE); ++head) {
+                const io_uring_cqe &cqe = ring.cqes[head & *ring.cq_mask];
+                Request &completed = requests[cqe.user_data];
+                completed.result = cqe.res;
+                completed.done = true;
+                __atomic_store_n(ring.cq_head, head + 1, __ATOMIC_RELEASE);
+                reaped = true;
+            }
+            return reaped;
+        }
+
+        /*
+         * Takes completions off the ring until the slot is done.
+         */
+        void reap_ring(unsigned slot) {
+            while (!requests[slot].done) {
+                if (!drain_ring() && enter(0, 1) < 0) throw std::runtime_error("io_uring wait failed");
+            }
+        }
+#endif
+
+        [[nodiscard]] bool ring_backend() const {
+#ifdef CES_IO_URING
+            return ring.fd >= 0;
+#else
+            return false;
+#endif
+        }
+
+        /*
+         * Does one request synchronously, on the background thread.
+         */
+        long long transfer(const Request &request) {
+#ifdef _WIN32
+            OVERLAPPED position{};
+            position.Offset = static_cast<DWORD>(request.offset);
+            position.OffsetHigh = static_cast<DWORD>(request.offset >> 32);
+            DWORD transferred = 0;
+            const BOOL ok = request.write
+                            ? WriteFile(handle, request.buffer, static_cast<DWORD>(request.size), &transferred, &position)
+                            : ReadFile(handle, request.buffer, static_cast<DWORD>(request.size), &transferred, &position);
+            if (!ok && GetLastError() != ERROR_HANDLE_EOF) return -static_cast<long long>(GetLastError());
+            return transferred;
+#else
+            while (true) {
+                const ssize_t result = request.write
+                                       ? ::pwrite(fd, request.buffer, request.size, static_cast<off_t>(request.offset))
+                                       : ::pread(fd, request.buffer, request.size, static_cast<off_t>(request.offset));
+                if (result >= 0 || errno != EINTR) return result >= 0 ? result : -errno;
+            }
+#endif
+        }
+
+        void work() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                wake.wait(lock, [&] { return stopping || !queue.empty(); });
+                if (queue.empty()) return;
+                const unsigned slot = queue.front();
+                queue.pop_front();
+                const Request request = requests[slot];
+                lock.unlock();
+                const long long result = transfer(request);
+                lock.lock();
+                requests[slot].result = result;
+                requests[slot].done = true;
+                done.notify_all();
+            }
+        }
+
+        void submit(unsigned slot) {
+            if (ring_backend()) {
+#ifdef CES_IO_URING
+                submit_ring(slot);
+#endif
+                return;
+            }
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                queue.push_back(slot);
+            }
+            wake.notify_one();
+        }
+
+        void start(unsigned slot, std::byte *buffer, std::size_t size, std::uint64_t offset, bool write) {
+            if (slot >= slot_count) throw std::out_of_range("No such slot");
+            if (requests[slot].pending) throw std::logic_error("The slot has a request in flight");
+            if (size > 0x7FFFF000) throw std::invalid_argument("A single transfer is limited to 2 GiB");
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                requests[slot] = Request{buffer, size, offset, write, true, false, 0, 0, false};
+            }
+            submit(slot);
+        }
+
+        /*
+         * Accounts for a part of a request that completed. The rest of a short transfer is submitted again, only a
+         * read that returns 0 bytes ends at the end of the file.
+         * @return true when the request is complete.
+         */
+        bool settle(unsigned slot) {
+            Request &request = requests[slot];
+            if (request.result < 0) {
+                request.pending = false;
+                throw std::runtime_error("Asynchronous " + std::string(request.write ? "write" : "read") +
+                                         " failed: " + std::to_string(-request.result));
+            }
+            request.transferred += static_cast<std::size_t>(request.result);
+            if (request.result == 0 || static_cast<std::size_t>(request.result) == request.size) return true;
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                request.buffer += request.result;
+                request.offset += static_cast<std::uint64_t>(request.result);
+                request.size -= static_cast<std::size_t>(request.result);
+                request.done = false;
+            }
+            submit(slot);
+            return false;
+        }
+
+    public:
+
+        /*
+         * Opens a file.
+         * @param path the path of the file.
+         * @param write true to create or truncate the file for writing, false to read it.
+         * @param slots the number of requests that can be in flight at once, at most 8.
+         * @param use_io_uring false forces the thread backend.
+         */
+        AsyncFile(const std::string &path, bool write, unsigned slots = 2, bool use_io_uring = true) : slot_count(slots) {
+            if (slots == 0 || slots > max_slots) throw std::invalid_argument("An AsyncFile has between 1 and 8 slots");
+#ifdef _WIN32
+            handle = CreateFileA(path.c_str(), write ? GENERIC_WRITE : GENERIC_READ, write ? 0 : FILE_SHARE_READ, nullptr,
+                                 write ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (handle == INVALID_HANDLE_VALUE) throw std::runtime_error("Could not open file: " + path);
+            (void) use_io_uring;
+#else
+            fd = write ? ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644) : ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) throw std::runtime_error("Could not open file: " + path);
+#ifdef CES_IO_URING
+            if (use_io_uring && setup_ring()) return;
+#else
+            (void) use_io_uring;
+#endif
+#endif
+            worker = std::thread([this] { work(); });
+        }
+
+        /*
+         * Waits for the requests in flight and closes the file.
+         */
+        ~AsyncFile() {
+            for (unsigned slot = 0; slot < slot_count; ++slot) {
+                try {
+                    if (requests[slot].pending) wait(slot);
+                } catch (...) {
+                }
+            }
+            if (worker.joinable()) {
+                {
+                    const std::lock_guard<std::mutex> lock(mutex);
+                    stopping = true;
+                }
+                wake.notify_one();
+                worker.join();
+            }
+#ifdef CES_IO_URING
+            close_ring();
+#endif
+#ifdef _WIN32
+            CloseHandle(handle);
+#else
+            ::close(fd);
+#endif
+        }
+
+        AsyncFile(const AsyncFile &) = delete;
+        AsyncFile &operator=(const AsyncFile &) = delete;
+
+        /*
+         * True when the requests go through io_uring, false for the thread backend.
+         */
+        [[nodiscard]] bool uses_io_uring() const { return ring_backend(); }
+
+        /*
+         * Starts reading size bytes at offset into buffer. The buffer has to stay valid until wait(slot) returns.
+         */
+        void read(unsigned slot, std::byte *buffer, std::size_t size, std::uint64_t offset) {
+            start(slot, buffer, size, offset, false);
+        }
+
+        /*
+         * Starts writing size bytes of buffer at offset. The buffer has to stay valid until wait(slot) returns.
+         */
+        void write(unsigned slot, const std::byte *buffer, std::size_t size, std::uint64_t offset) {
+            start(slot, const_cast<std::byte *>(buffer), size, offset, true);
+        }
+
+        /*
+         * Checks without blocking whether the request of a slot is complete, for callers that poll from an event
+         * loop or a coroutine scheduler. A short part is submitted again here, as in wait.
+         * @return true when wait(slot) returns without blocking.
+         */
+        bool ready(unsigned slot) {
+            Request &request = requests[slot];
+            if (!request.pending) throw std::logic_error("The slot has no request in flight");
+            if (request.complete) return true;
+            bool done;
+            if (ring_backend()) {
+#ifdef CES_IO_URING
+                drain_ring();
+#endif
+                done = request.done;
+            } else {
+                const std::lock_guard<std::mutex> lock(mutex);
+                done = request.done;
+            }
+            if (!done) return false;
+            request.complete = settle(slot);
+            return request.complete;
+        }
+
+        /*
+         * Waits for the request of a slot. The rest of a short read or write is submitted again, so a write is
+         * finished completely and a read only stops short at the end of the file.
+         * @return the number of bytes transferred.
+         */
+        std::size_t wait(unsigned slot) {
+            Request &request = requests[slot];
+            if (!request.pending) throw std::logic_error("The slot has no request in flight");
+            while (!request.complete) {
+                if (ring_backend()) {
+#ifdef CES_IO_URING
+                    reap_ring(slot);
+#endif
+                } else {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    done.wait(lock, [&] { return request.done; });
+                }
+                request.complete = settle(slot);
+            }
+            request.pending = false;
+            if (request.write && request.transferred == 0 && request.size != 0) throw std::runtime_error("Asynchronous write made no progress");
+            return request.transferred;
+        }
+    };
+
+    class AsyncReader {
+        AsyncFile file;
+        std::unique_ptr<std::byte[]> buffers[2];
+        std::size_t filled[2] = {0, 0};
+        std::size_t block_size;
+        std::uint64_t next_offset = 0;
+        unsigned current = 0;
+        std::size_t begin = 0;
+        bool at_eof = false; // no read is submitted past a short one, which only happens at the end of the file.
+        bool primed = false; // the first block was waited for.
+
+        /*
+         * Starts reading the next block of the file into a buffer.
+         */
+        void prefetch(unsigned slot) {
+            file.read(slot, buffers[slot].get(), block_size, next_offset);
+            next_offset += block_size;
+        }
+
+        /*
+         * Moves to the other buffer: the consumed one is refilled in the background, the other one is waited for.
+         * @return false at the end of the file.
+         */
+        bool advance() {
+            if (at_eof) return false;
+            if (filled[current] == block_size) prefetch(current);
+            else at_eof = true;
+            current ^= 1;
+            begin = 0;
+            filled[current] = file.wait(current);
+            if (filled[current] < block_size) at_eof = true;
+            return filled[current] != 0;
+        }
+
+        void prime() {
+            if (primed) return;
+            primed = true;
+            filled[0] = file.wait(0);
+            if (filled[0] < block_size) at_eof = true;
+        }
+
+    public:
+
+        /*
+         * Opens a file and starts reading its first two blocks.
+         * @param path the path of a file written by the BinaryConverter, an AsyncWriter or any writer of the format.
+         * @param block_size the number of bytes read at once, per buffer.
+         * @param use_io_uring false forces the thread backend.
+         */
+        explicit AsyncReader(const std::string &path, std::size_t block_size = 1 << 20, bool use_io_uring = true)
+                : file(path, false, 2, use_io_uring), block_size(block_size) {
+            if (block_size == 0) throw std::invalid_argument("Block size must not be 0");
+            buffers[0].reset(new std::byte[block_size]);
+            buffers[1].reset(new std::byte[block_size]);
+            prefetch(0);
+            prefetch(1);
+        }
+
+        AsyncReader(const AsyncReader &) = delete;
+        AsyncReader &operator=(const AsyncReader &) = delete;
+
+        [[nodiscard]] bool uses_io_uring() const { return file.uses_io_uring(); }
+
+        /*
+         * True when next_block() returns without waiting for the file. A coroutine or an event loop polls it and
+         * does other work in between, instead of blocking in next_block().
+         */
+        bool block_ready() {
+            if (!primed) return file.ready(0);
+            return at_eof || file.ready(current ^ 1);
+        }
+
+        /*
+         * The next block of raw bytes, the file is read ahead while it is used. Valid until the next call.
+         * Either use the blocks or the read functions, not both.
+         * @return an empty span at the end of the file.
+         */
+        std::span<const std::byte> next_block() {
+            if (!primed) prime();
+            else if (!advance()) return {};
+            begin = filled[current];
+            return {buffers[current].get(), filled[current]};
+        }
+
+        /*
+         * Hands every block of the file to a callback, on_block(std::span<const std::byte>). The next block is read
+         * while the callback works on the current one.
+         * @return the number of bytes of the file.
+         */
+        template<typename F>
+        std::size_t for_each_block(F &&on_block) {
+            std::size_t total = 0;
+            for (std::span<const std::byte> block = next_block(); !block.empty(); block = next_block()) {
+                on_block(block);
+                total += block.size();
+            }
+            return total;
+        }
+
+        /*
+         * Deserializes the values of the file one after the other into the same object and hands each one to a
+         * callback, on_value(const T &), until the end of the file. The values have to be of type T.
+         */
+        template<typename T, typename F>
+        void for_each(F &&on_value) {
+            T obj{};
+            while (!at_end()) {
+                read(obj);
+                on_value(static_cast<const T &>(obj));
+            }
+        }
+
+        /*
+         * Copies count bytes out of the blocks. This is the read interface of the BinaryConverter sources.
+         */
+        void read(void *destination, std::size_t count) {
+            prime();
+            auto *out = static_cast<std::byte *>(destination);
+            while (count != 0) {
+                if (begin == filled[current] && !advance()) throw std::runtime_error("Unexpected end of file");
+                const std::size_t n = std::min(count, filled[current] - begin);
+                std::memcpy(out, buffers[current].get() + begin, n);
+                begin += n;
+                out += n;
+                count -= n;
+            }
+        }
+
+        /*
+         * Moves past count bytes.
+         */
+        void skip(std::size_t count) {
+            prime();
+            while (count != 0) {
+                if (begin == filled[current] && !advance()) throw std::runtime_error("Unexpected end of file");
+                const std::size_t n = std::min(count, filled[current] - begin);
+                begin += n;
+                count -= n;
+            }
+        }
+
+        /*
+         * True when every byte of the file was consumed.
+         */
+        bool at_end() {
+            prime();
+            while (begin == filled[current]) {
+                if (!advance()) return true;
+            }
+            return false;
+        }
+
+        /*
+         * Deserializes the next value. Accepts everything BinaryConverter::deserialize accepts.
+         */
+        template<typename T>
+        void read(T &obj) { BinaryConverter::read_value(obj, *this); }
+
+        /*
+         * Moves past the next value without decoding it.
+         * @return its type flag.
+         */
+        type skip_value() {
+            char header[BinaryConverter::header_size];
+            read(header, sizeof(header));
+            const auto t = static_cast<type>(header[1]);
+            BinaryConverter::skip_payload(t, static_cast<system_type>(header[0]) != BinaryConverter::detect_system_type(), *this);
+            return t;
+        }
+    };
+
+    class AsyncWriter {
+        AsyncFile file;
+        std::unique_ptr<std::byte[]> buffers[2];
+        bool in_flight[2] = {false, false};
+        std::size_t block_size;
+        std::uint64_t offset = 0;
+        unsigned current = 0;
+        std::size_t used = 0;
+        ByteBuffer large; // values larger than a block are encoded here.
+
+        /*
+         * Submits the current buffer and switches to the other one, after its previous write is done.
+         */
+        void submit() {
+            if (used == 0) return;
+            file.write(current, buffers[current].get(), used, offset);
+            in_flight[current] = true;
+            offset += used;
+            used = 0;
+            current ^= 1;
+            if (in_flight[current]) {
+                in_flight[current] = false;
+                file.wait(current);
+            }
+        }
+
+    public:
+
+        /*
+         * Creates or truncates a file.
+         * @param path the path of the file.
+         * @param block_size the number of bytes written at once, per buffer.
+         * @param use_io_uring false forces the thread backend.
+         */
+        explicit AsyncWriter(const std::string &path, std::size_t block_size = 1 << 20, bool use_io_uring = true)
+                : file(path, true, 2, use_io_uring), block_size(block_size) {
+            if (block_size == 0) throw std::invalid_argument("Block size must not be 0");
+            buffers[0].reset(new std::byte[block_size]);
+            buffers[1].reset(new std::byte[block_size]);
+        }
+
+        /*
+         * Writes what is buffered. Errors are swallowed, call flush to see them.
+         */
+        ~AsyncWriter() {
+            try {
+                flush();
+            } catch (...) {
+            }
+        }
+
+        AsyncWriter(const AsyncWriter &) = delete;
+        AsyncWriter &operator=(const AsyncWriter &) = delete;
+
+        [[nodiscard]] bool uses_io_uring() const { return file.uses_io_uring(); }
+
+        /*
+         * Serializes a value into the current buffer. A full buffer is written in the background while the next
+         * values are encoded into the other one.
+         */
+        template<typename T>
+        void write(const T &obj) {
+            const std::size_t size = BinaryConverter::size_of(obj);
+            if (size > block_size - used) submit();
+            if (size <= block_size) {
+                BinaryConverter::encode(obj, buffers[current].get() + used);
+                used += size;
+                return;
+            }
+            large.clear(); // too large for a buffer: written on its own, synchronously.
+            BinaryConverter::encode(obj, large.grow(size));
+            file.write(current, large.data(), size, offset);
+            file.wait(current);
+            offset += size;
+        }
+
+        template<typename T, std::size_t N>
+        void write(const T (&arr)[N]) { write<T[N]>(arr); }
+
+        /*
+         * Writes the buffered bytes and waits until every write is done.
+         */
+        void flush() {
+            submit();
+            for (unsigned slot = 0; slot < 2; ++slot) {
+                if (in_flight[slot]) {
+                    in_flight[slot] = false;
+                    file.wait(slot);
+                }
+            }
+        }
+    };
+}
+#endif //BINARY_DATA_PROCESSING_ASYNCIO_HPP
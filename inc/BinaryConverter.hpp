@@ -12,28 +12,225 @@
  * @date 2024-03-03
  * @version 1.0
  * @details This file provides utilities for serializing and deserializing data to/from different types of input/output channel.
- * It includes functions for handling serialization and deserialization for basic data types
+ * It includes functions for handling serialization and deserialization for basic data types, strings, C arrays and the
+ * standard containers (std::vector, std::array, std::span and std::string_view for writing), and structs that register
+ * their fields with CES_FIELDS.
  * @copyright CES Public License
  */
 
-#include <typeinfo>
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "ByteBuffer.hpp"
+#include "BitPacking.hpp"
+#include "ByteSwap.hpp"
+#include "Encodings.hpp"
+#include "Reflection.hpp"
+#include "SeriesCoder.hpp"
+#include "Stats.hpp"
+#include "StringDictionary.hpp"
+#include "StringTable.hpp"
 #include "TypeDefinitions.hpp"
+#include "Varint.hpp"
 
 namespace CES {
+    class AsyncReader;
+    class AsyncWriter;
+    class ChecksummedReader;
+    class ChecksummedWriter;
+    class ColumnReader;
+    class Compressor;
+    class ContainerReader;
+    class ContainerWriter;
+    template<typename T>
+    class LazyArray;
+    class MappedReader;
+    class ParallelConverter;
+    class RecordWriter;
+    class RecordReader;
+    class SharedRing;
+    template<typename T>
+    class ZonedArray;
+
+    /*
+     * std::vector<bool> stores bits, so its elements are copied one by one.
+     */
+    template<typename T>
+    inline constexpr bool is_bit_vector = false;
+
+    template<typename Allocator>
+    inline constexpr bool is_bit_vector<std::vector<bool, Allocator>> = true;
+
     class BinaryConverter {
         /*
-         * Serializes the elements of different arrays.
-         * @param elem the element of the array to be serialized.
-         * @param ostream the output stream where the element is going to be serialized.
+         * The system type flag and the data type flag that precede every serialized value.
+         */
+        static constexpr std::size_t header_size = 2;
+
+        /*
+         * Reads from an input stream. It has the same read interface as the ByteReader, so the deserialization code
+         * is shared between the stream and the buffer backends.
+         */
+        struct StreamSource {
+            std::istream &istream;
+            std::size_t consumed = 0; // only counted for the Stats.
+
+            void read(void *destination, std::size_t count) {
+                istream.read(static_cast<char *>(destination), static_cast<std::streamsize>(count));
+                if constexpr (Stats::enabled) consumed += count;
+            }
+
+            void skip(std::size_t count) {
+                istream.ignore(static_cast<std::streamsize>(std::min<std::size_t>(count, std::numeric_limits<std::streamsize>::max())));
+                if (static_cast<std::size_t>(istream.gcount()) != count) throw std::runtime_error("Unexpected end of stream");
+                if constexpr (Stats::enabled) consumed += count;
+            }
+        };
+
+        /*
+         * The length prefix of a string comes from the input, so it is checked against this limit before anything
+         * is allocated. Large enough for real data, small enough that a corrupted prefix does not exhaust memory.
+         */
+        inline static std::atomic<std::size_t> string_length_limit{std::size_t{1} << 30};
+
+        /*
+         * Throws if a stored string length is above the limit.
+         */
+        static void check_string_length(std::size_t length);
+
+        /*
+         * The most a length prefix allocates ahead of its bytes when the source cannot tell how many bytes are left.
+         */
+        static constexpr std::size_t growth_step = std::size_t{1} << 20;
+
+        /*
+         * False once a stream source ran out of bytes. Stream reads do not throw, the caller finds the stream failed;
+         * the other sources throw at their end.
+         */
+        template<typename Source>
+        static bool source_ok(const Source &source) {
+            if constexpr (requires { source.istream; }) return static_cast<bool>(source.istream);
+            else return true;
+        }
+
+        /*
+         * Strings, arrays and containers are written with a length prefix, single values are not.
+         */
+        template<typename T>
+        static constexpr bool is_sequence = type_tag_v<T> == STRING || (type_tag_v<T> >= INT_ARRAY && type_tag_v<T> <= PACKED_BOOL_ARRAY);
+
+        /*
+         * Structs with registered fields (see Reflection.hpp). They have one header for all their fields.
+         */
+        template<typename T>
+        static constexpr bool is_struct = type_tag_v<T> == STRUCT;
+
+        /*
+         * Wrappers that encode their own payload, like CES::columnar (see Columns.hpp).
+         */
+        template<typename T>
+        static constexpr bool is_self_encoding = requires(const T &obj, std::byte *out) {
+            { obj.payload_size() } -> std::same_as<std::size_t>;
+            { obj.encode_payload(out) } -> std::same_as<std::byte *>;
+        };
+
+        /*
+         * Integers and arrays of integers, the types that can also be stored as varints (see CES::varint).
          */
         template<typename T>
-        static void serialize_element(const T &elem, std::ostream &ostream);
+        static constexpr bool has_varint_encoding = type_tag_v<T> <= UNSIGNED_LONG_LONG ||
+                                                    (type_tag_v<T> >= INT_ARRAY && type_tag_v<T> <= UNSIGNED_LONG_LONG_ARRAY);
 
         /*
-         * Finds the type of data structures and returns an enumerator.
+         * Arrays of integers, which can also be stored as deltas, and of floats or doubles, which can also be stored
+         * as XORs (see CES::delta and CES::xor_floats).
          */
         template<typename T>
-        static type find_type(T);
+        static constexpr bool has_delta_encoding = type_tag_v<T> >= INT_ARRAY && type_tag_v<T> <= UNSIGNED_LONG_LONG_ARRAY;
+
+        template<typename T>
+        static constexpr bool has_xor_encoding = type_tag_v<T> == FLOAT_ARRAY || type_tag_v<T> == DOUBLE_ARRAY;
+
+        /*
+         * Arrays of integers, floats and doubles, which can also be stored with a zone map (see CES::zone_map).
+         */
+        template<typename T>
+        static constexpr bool has_zone_map = type_tag_v<T> >= INT_ARRAY && type_tag_v<T> <= DOUBLE_ARRAY;
+
+        /*
+         * String arrays, which can also be stored with a dictionary (see CES::dictionary), and CodedStrings, which
+         * also reads plain string arrays.
+         */
+        template<typename T>
+        static constexpr bool has_dictionary_encoding = type_tag_v<T> == STRING_ARRAY || std::is_same_v<T, CodedStrings>;
+
+        /*
+         * std::vector and std::basic_string are resized to the stored length, arrays must be large enough.
+         */
+        template<typename T>
+        static constexpr bool is_resizable = requires(T &obj) { obj.resize(std::size_t{}); };
+
+        /*
+         * The element type of a string, array or container.
+         */
+        template<typename T>
+        using element_t = std::remove_cvref_t<decltype(*std::begin(std::declval<const T &>()))>;
+
+        /*
+         * Containers of bools: bool arrays, std::array<bool, N>, std::vector<bool>, std::bitset and packed().
+         */
+        template<typename T>
+        static constexpr bool is_bool_sequence = type_tag_v<T> == BOOL_ARRAY || type_tag_v<T> == PACKED_BOOL_ARRAY;
+
+        /*
+         * Bools that can be addressed as a bool *, which is what the SIMD pack and unpack kernels work on.
+         */
+        template<typename T>
+        static constexpr bool has_bool_data = requires(T &obj) { { std::data(obj) } -> std::same_as<bool *>; };
+
+        /*
+         * The payload after the length prefix is a plain copy of the memory of the object, so it can be written
+         * straight from the object and read straight into it.
+         */
+        template<typename T>
+        static constexpr bool is_contiguous = is_sequence<T> && type_tag_v<T> != STRING_ARRAY &&
+                                              type_tag_v<T> != PACKED_BOOL_ARRAY && !is_bit_vector<T>;
+
+        /*
+         * Checks a stored type flag: the type flag of T, or an alternative encoding of it (see Encodings.hpp).
+         */
+        template<typename T>
+        static constexpr bool accepts(type t) {
+            if (t == type_tag_v<T>) return true;
+            if constexpr (is_bool_sequence<T>) return t == BOOL_ARRAY || t == PACKED_BOOL_ARRAY;
+            if constexpr (has_dictionary_encoding<T>) return t == STRING_ARRAY || t == DICTIONARY_STRING_ARRAY;
+            if constexpr (has_varint_encoding<T>) {
+                if (t == type_tag_v<Varints<T>>) return true;
+            }
+            if constexpr (has_zone_map<T>) {
+                if (t == ZONED_ARRAY) return true;
+            }
+            if constexpr (has_delta_encoding<T>) return t == DELTA_ARRAY || t == DELTA_OF_DELTA_ARRAY;
+            if constexpr (has_xor_encoding<T>) return t == XOR_FLOAT_ARRAY;
+            return false;
+        }
 
         /*
          * Finds the endianess (LE/BE/I don't believe that ME exists) of the system that serializes/deserializes for the values to match.
@@ -42,22 +239,205 @@ namespace CES {
 
         /*
          * If the endianess does not match, it swaps the bytes, so that the value is not lost.
+         * Works for every integral and floating point width (see ByteSwapper::swap).
          * @param The obj of which the bytes are being swapped.
          */
         template<typename T>
         static T switch_bytes(T &obj);
 
+        /*
+         * The type flag an object is written with: type_tag_v<T>, or the one the object picks when it chooses its
+         * encoding from its contents (see CES::dictionary).
+         */
+        template<typename T>
+        static type type_of(const T &obj);
+
+        /*
+         * Writes the system type flag and the data type flag.
+         * @return the position after the header.
+         */
+        static std::byte *write_header(type t, std::byte *out);
+
+        /*
+         * Writes the header and the payload of an object. The memory has to hold size_of(obj) bytes.
+         * @return the position after the object.
+         */
+        template<typename T>
+        static std::byte *encode(const T &obj, std::byte *out);
+
+        /*
+         * Writes an object to a stream with as few writes as possible, serialize without the Stats.
+         */
+        template<typename T>
+        static void write_to(const T &obj, std::ostream &ostream);
+
+        /*
+         * Writes the payload of an object without the header: the value, or the length followed by the elements.
+         * The memory has to hold payload_size(obj) bytes.
+         * @return the position after the payload.
+         */
+        template<typename T>
+        static std::byte *encode_payload(const T &obj, std::byte *out);
+
+        /*
+         * Computes the number of bytes encode_payload writes.
+         */
+        template<typename T>
+        static std::size_t payload_size(const T &obj);
+
+        /*
+         * Deserializes a value, a string, an array or a container from a source (StreamSource or ByteReader).
+         */
+        template<typename T, typename Source>
+        static void read_value(T &obj, Source &source);
+
+        /*
+         * Deserializes the payload of an object whose header was already read.
+         * @param t the stored type flag, accepts<T>(t) has to be true.
+         * @param swap true when the writer had the other endianess.
+         */
+        template<typename T, typename Source>
+        static void read_payload(T &obj, type t, bool swap, Source &source);
+
+        /*
+         * Makes room for size elements: containers are resized, arrays have to be large enough already.
+         */
+        template<typename T>
+        static void prepare(T &obj, std::size_t size);
+
+        /*
+         * Makes room for size elements and reads them with read(first, count). Sources with remaining() were checked
+         * against the length prefix already. For the others a container grows growth_step bytes at a time while
+         * the elements arrive, so a corrupt prefix runs into the end of the data instead of one huge allocation.
+         */
+        template<typename T, typename Source, typename Read>
+        static void read_growing(T &obj, std::size_t size, Source &source, Read read);
+
+        /*
+         * Reads a single varint, one byte at a time.
+         */
+        template<typename Source>
+        static std::uint64_t read_varint(Source &source);
+
+        /*
+         * Reads the payload of a VARINT, ZIGZAG_VARINT, VARINT_ARRAY or ZIGZAG_VARINT_ARRAY.
+         */
+        template<typename T, typename Source>
+        static void read_varints(T &obj, Source &source);
+
+        /*
+         * Reads the payload of a DELTA_ARRAY, DELTA_OF_DELTA_ARRAY or XOR_FLOAT_ARRAY, decoding it straight into the
+         * elements of the destination.
+         */
+        template<typename T, typename Source>
+        static void read_series(T &obj, type t, bool swap, Source &source);
+
+        /*
+         * Reads the payload of a DICTIONARY_STRING_ARRAY, materializing the strings unless the destination is
+         * CodedStrings, or the payload of a STRING_ARRAY into CodedStrings.
+         */
+        template<typename T, typename Source>
+        static void read_dictionary(T &obj, type t, bool swap, Source &source);
+
+        /*
+         * Reads the payload of a ZONED_ARRAY, moving past the zones to the elements.
+         */
+        template<typename T, typename Source>
+        static void read_zoned(T &obj, bool swap, Source &source);
+
+        /*
+         * The payloads of the fields of a struct, without the signature and the length: the encoding of a struct
+         * that is nested in another struct.
+         */
+        template<typename T>
+        static std::size_t fields_size(const T &obj);
+
+        template<typename T>
+        static std::byte *encode_fields(const T &obj, std::byte *out);
+
+        template<typename T, typename Source>
+        static void read_fields(T &obj, bool swap, Source &source);
+
+        /*
+         * Reads bools into a container that is not a plain bool array, or bools that were stored packed.
+         * @param first the index of the first bool read.
+         */
+        template<typename T, typename Source>
+        static void read_bools(T &obj, std::size_t size, bool packed, Source &source, std::size_t first = 0);
+
+        /*
+         * Packs the bools of a container, 8 per byte.
+         */
+        template<typename T>
+        static void write_bools(const T &obj, std::byte *out);
+
+        /*
+         * Reads the payload of a string, array or container whose length was already read.
+         * @param obj the destination, it holds at least first + size elements.
+         * @param swap true when the writer had the other endianess.
+         * @param first the index of the first element read.
+         */
+        template<typename T, typename Source>
+        static void read_elements(T &obj, std::size_t size, bool swap, Source &source, std::size_t first = 0);
+
+        /*
+         * Moves past the payload of a value whose header was already read, using its type flag and length prefix.
+         * Sources with a skip(count) or take(count) member jump over the bytes, others read them into a scratch buffer.
+         * @param t the stored type flag.
+         * @param swap true when the writer had the other endianess.
+         */
+        template<typename Source>
+        static void skip_payload(type t, bool swap, Source &source);
+
+        template<typename Source>
+        static void discard(std::size_t count, Source &source);
+
+        friend class AsyncReader;
+        friend class AsyncWriter;
+        friend class ChecksummedReader;
+        friend class ChecksummedWriter;
+        friend class ColumnReader;
+        friend class Compressor;
+        friend class ContainerReader;
+        friend class ContainerWriter;
+        template<typename T>
+        friend class LazyArray;
+        friend class MappedReader;
+        friend class ParallelConverter;
+        friend class RecordWriter;
+        friend class RecordReader;
+        friend class SharedRing;
+        template<typename T>
+        friend class ZonedArray;
+
     public:
 
         BinaryConverter() = delete;
 
         /*
-         * Serializes an object to an output stream. It uses template specializations to differentiate between the different data types.
+         * Sets the longest string deserialize accepts, for single strings and for every element of a string array.
+         * The default is 1 GiB.
+         * @param length the maximum number of characters.
+         */
+        static void set_max_string_length(std::size_t length);
+
+        static std::size_t max_string_length();
+
+        /*
+         * Computes the number of bytes serialize writes for an object, header included.
+         * @param obj the object that is going to be serialized.
+         */
+        template<typename T>
+        static std::size_t size_of(const T &obj);
+
+        /*
+         * Serializes an object to an output stream. The object is encoded in memory and written with as few
+         * stream writes as possible (one for single values, two for strings and arrays).
          * @param obj the object to be serialized.
          * @param ostream the output stream where the object is going to be serialized.
          */
         template<typename T>
-        static void serialize(T &obj, std::ostream &ostream);
+        static void serialize(const T &obj, std::ostream &ostream);
 
         /*
          * Serializes an array of objects to an output stream.
@@ -65,10 +445,41 @@ namespace CES {
          * @param ostream the output stream where the objects are going to be serialized.
          */
         template<typename T, std::size_t N>
-        static void serialize(T (&arr)[N], std::ostream &ostream);
+        static void serialize(const T (&arr)[N], std::ostream &ostream);
+
+        /*
+         * Appends a serialized object (single value, string or array) to a buffer.
+         * @param obj the object to be serialized.
+         * @param buffer the buffer the bytes are appended to. It grows when needed.
+         */
+        template<typename T>
+        static void serialize(const T &obj, ByteBuffer &buffer);
+
+        /*
+         * Serializes an object into memory owned by the caller.
+         * @param obj the object to be serialized.
+         * @param buffer the memory the object is written to. It has to hold at least size_of(obj) bytes.
+         * @return the number of bytes written.
+         */
+        template<typename T>
+        static std::size_t serialize_into(const T &obj, std::span<std::byte> buffer);
+
+        /*
+         * Moves past the next value of a stream without decoding it, using its type flag and length prefix.
+         * @param istream the input stream, positioned at the header of the value.
+         * @return the type flag of the value that was skipped.
+         */
+        static type skip(std::istream &istream);
 
         /*
-         * Deserializes an object. It uses a switch statement based on the type enumerator to differentiate between the different data types.
+         * Moves past the next value in memory without decoding it.
+         * @param buffer the bytes, starting with the header of the value.
+         * @return the number of bytes of the value, the next value starts there.
+         */
+        static std::size_t skip(std::span<const std::byte> buffer);
+
+        /*
+         * Deserializes an object. The type flag that was stored has to match type_tag_v<T>.
          * @param elem the object to be deserialized.
          * @param istream the input stream where it reads the data from.
          */
@@ -77,12 +488,46 @@ namespace CES {
 
 
         /*
-         * Deserializes an array of objects. It a switch statement based on the type enumerator to differentiate between the different data types.
+         * Deserializes an array of objects. The type flag that was stored has to match type_tag_v<T[N]>.
          * @param elem the object to be deserialized.
          * @param istream the input stream where it reads the data from.
          */
         template<typename T, std::size_t N>
         static void deserialize(T (&arr)[N], std::istream &istream);
+
+        /*
+         * Deserializes an object from memory, for example from a ByteBuffer.
+         * @param obj the object to be deserialized.
+         * @param buffer the bytes it reads the data from.
+         * @return the number of bytes consumed, the next object starts there.
+         */
+        template<typename T>
+        static std::size_t deserialize(T &obj, std::span<const std::byte> buffer);
+
+        /*
+         * Deserializes an array of objects from memory.
+         * @param arr the array to be filled.
+         * @param buffer the bytes it reads the data from.
+         * @return the number of bytes consumed, the next object starts there.
+         */
+        template<typename T, std::size_t N>
+        static std::size_t deserialize(T (&arr)[N], std::span<const std::byte> buffer);
+
+        /*
+         * Deserializes a new object whose strings and arrays are allocated from a memory resource, for example an
+         * Arena. T is constructed with a std::pmr::polymorphic_allocator when it takes one (std::pmr::string,
+         * std::pmr::vector of numbers or of std::pmr::string), its elements get the same allocator.
+         * @param buffer the bytes it reads the data from.
+         * @param resource where the memory of the object comes from. It has to outlive the object.
+         */
+        template<typename T>
+        static T deserialize(std::span<const std::byte> buffer, std::pmr::memory_resource *resource);
+
+        /*
+         * Deserializes a new object from a stream, allocating from a memory resource.
+         */
+        template<typename T>
+        static T deserialize(std::istream &istream, std::pmr::memory_resource *resource);
     };
 
     inline system_type BinaryConverter::detect_system_type() {
@@ -93,465 +538,716 @@ namespace CES {
 
     template<typename T>
     T BinaryConverter::switch_bytes(T &obj) {
-        const int total_bits = sizeof(T) * 8;
-        int final = 0;
-        for (int i = 0; i < total_bits; i += 8) {
-            const int byte = (obj >> i) & 0xFF; //shifts the bytes that is being processed, then masks the higher order bytes.
-            final |= (byte << (total_bits - 8 - i)); // shifts the byte to the left and combines with the other bytes that were processed
-        }
-        obj = final;
+        obj = ByteSwapper::swap(obj); // dispatches on sizeof(T), so 8 and 16 byte values and floats keep every byte.
         return obj;
     }
 
-    template<typename T>
-    void BinaryConverter::deserialize(T &obj, std::istream &istream) {
-        char t_char, sts_char;
-        istream.get(sts_char);
-        istream.get(t_char);
+    template<typename T, typename Source>
+    void BinaryConverter::read_value(T &obj, Source &source) {
+        constexpr type expected = type_tag_v<T>; // the only type flag this overload accepts, known at compile time.
+        char header[header_size];
+        source.read(header, header_size);
 
-        const auto t = static_cast<type>(t_char); // gets the type of the object that was stored
-        const auto sts = static_cast<system_type>(sts_char);
+        const auto t = static_cast<type>(header[1]); // gets the type of the object that was stored
+        const auto sts = static_cast<system_type>(header[0]);
         const system_type st = detect_system_type(); // gets the type of the system and the type of the system that serialized the data.
-        switch (t) { // deserializes data based on the type of the data that was serialized. The main difference between these cases is the size of the data that was serialized.
-            case INT:
-                if (typeid(int) != typeid(T))
-                    throw std::invalid_argument("Specified data type does not match serialized data type");
-                istream.read(reinterpret_cast<char *>(&obj), sizeof(int));
-                break;
-            case UNSIGNED_INT:
-                if (typeid(unsigned int) != typeid(T))
-                    throw std::invalid_argument("Specified data type does not match serialized data type");
-                istream.read(reinterpret_cast<char *>(&obj), sizeof(unsigned int));
-                break;
-            case SHORT:
-                if (typeid(short) != typeid(T))
-                    throw std::invalid_argument("Object type does not match serialized data type");
-                istream.read(reinterpret_cast<char *>(&obj), sizeof(short));
-                break;
-            case UNSIGNED_SHORT:
-                if (typeid(unsigned short) != typeid(T))
-                    throw std::invalid_argument("Object type does not match serialized data type (UNSIGNED SHORT)");
-                istream.read(reinterpret_cast<char *>(&obj), sizeof(unsigned short));
-                break;
-            case LONG:
-                if (typeid(long) != typeid(T))
-                    throw std::invalid_argument("Object type does not match serialized data type (LONG)");
-                istream.read(reinterpret_cast<char *>(&obj), sizeof(long));
-                break;
-            case UNSIGNED_LONG:
-                if (typeid(unsigned long) != typeid(T))
-                    throw std::invalid_argument("Object type does not match serialized data type (UNSIGNED LONG)");
-                istream.read(reinterpret_cast<char *>(&obj), sizeof(unsigned long));
-                break;
-            case LONG_LONG:
-                if (typeid(long long) != typeid(T))
-                    throw std::invalid_argument("Object type does not match serialized data type (LONG LONG)");
-                istream.read(reinterpret_cast<char *>(&obj), sizeof(long long));
-                break;
-            case UNSIGNED_LONG_LONG:
-                if (typeid(unsigned long long) != typeid(T))
-                    throw std::invalid_argument("Object type does not match serialized data type (UNSIGNED LONG LONG)");
-                istream.read(reinterpret_cast<char *>(&obj), sizeof(unsigned long long));
-                break;
-            case FLOAT:
-                if (typeid(float) != typeid(T))
-                    throw std::invalid_argument("Object type does not match serialized data type (FLOAT)");
-                istream.read(reinterpret_cast<char *>(&obj), sizeof(float));
-                break;
-            case DOUBLE:
-                if (typeid(double) != typeid(T))
-                    throw std::invalid_argument("Object type does not match serialized data type (DOUBLE)");
-                istream.read(reinterpret_cast<char *>(&obj), sizeof(double));
-                break;
-            case LONG_DOUBLE:
-                if (typeid(long double) != typeid(T))
-                    throw std::invalid_argument("Object type does not match serialized data type (LONG DOUBLE)");
-                istream.read(reinterpret_cast<char *>(&obj), sizeof(long double));
-                break;
-            case STRING:
-                if constexpr (std::is_same_v<T, std::string>) {
-                    size_t size;
-                    istream.read(reinterpret_cast<char *>(&size), sizeof(size_t));
-
-                    char test[size];
-                    istream.read(reinterpret_cast<char *>(&test), static_cast<std::streamsize>(size));
-                    test[size] = '\0';
-                    obj = test;
-                } else throw std::invalid_argument("Object type does not match serialized data type (STRING)");
-                break;
-            case CHAR:
-                if (typeid(char) != typeid(T))
-                    throw std::invalid_argument("Object type does not match serialized data type (CHAR)");
-                istream.read(reinterpret_cast<char *>(&obj), sizeof(char));
-                break;
-            case UNSIGNED_CHAR:
-                if (typeid(unsigned char) != typeid(T))
-                    throw std::invalid_argument("Object type does not match serialized data type (UNSIGNED CHAR)");
-                istream.read(reinterpret_cast<char *>(&obj), sizeof(unsigned char));
-                break;
-            case BOOL:
-                if (typeid(bool) != typeid(T))
-                    throw std::invalid_argument("Object type does not match serialized data type (bool)");
-                istream.read(reinterpret_cast<char *>(&obj), sizeof(bool));
-                break;
-            default:
-                throw std::invalid_argument("Data type not accepted");
-        }
-        if (st != sts) {
-            if constexpr (!std::is_same_v<T, std::string> && !std::is_same_v<T, char> &&
-                          !std::is_same_v<T, unsigned char> && !std::is_same_v<T, bool>) {
-                switch_bytes(obj);
-            }
-        }
+        if (!accepts<T>(t))
+            throw std::invalid_argument(std::string("Object type does not match serialized data type (") + type_name(expected) + ")");
+
+        read_payload(obj, t, st != sts, source);
     }
 
-    template<typename T, std::size_t N>
-    void BinaryConverter::deserialize(T (&arr)[N], std::istream &istream) {
-        size_t size;
-        char t_char, sts_char;
-        istream.get(sts_char);
-        istream.get(t_char);
+    template<typename T, typename Source>
+    void BinaryConverter::read_payload(T &obj, type t, bool swap, Source &source) {
+        if constexpr (has_varint_encoding<T>) {
+            if (is_varint(t)) return read_varints(obj, source); // varints have no byte order, nothing to swap.
+        }
+        if constexpr (has_delta_encoding<T> || has_xor_encoding<T>) {
+            if (is_series(t)) return read_series(obj, t, swap, source);
+        }
+        if constexpr (has_zone_map<T>) {
+            if (t == ZONED_ARRAY) return read_zoned(obj, swap, source);
+        }
+        if constexpr (type_tag_v<T> == STRING_ARRAY) {
+            if (t == DICTIONARY_STRING_ARRAY) return read_dictionary(obj, t, swap, source);
+        }
+        if constexpr (is_struct<T>) {
+            std::uint32_t signature;
+            source.read(&signature, sizeof(signature));
+            if (swap) switch_bytes(signature);
+            if (signature != Reflection::signature<T>())
+                throw std::invalid_argument("Struct fields do not match the fields of the serialized struct");
+            read_varint(source); // the length of the fields, only needed to skip the struct.
+            read_fields(obj, swap, source);
+        } else if constexpr (is_sequence<T>) {
+            size_t size;
+            source.read(&size, sizeof(size_t));
+            if (swap) switch_bytes(size); // the length prefix is written in the byte order of the writer as well.
 
-        const auto t = static_cast<type>(t_char);
-        const auto sts = static_cast<system_type>(sts_char);
-        const system_type st = detect_system_type();
+            if constexpr (type_tag_v<T> == STRING) check_string_length(size);
+            if constexpr (requires { source.remaining(); }) {
+                // checked before anything is allocated: a string of the array takes its length prefix at least.
+                const bool truncated = t == PACKED_BOOL_ARRAY ? size / 8 > source.remaining()
+                                                              : size > source.remaining() / (t == STRING_ARRAY ? sizeof(size_t) : element_size(t));
+                if (truncated) throw std::runtime_error("Unexpected end of buffer");
+            }
 
-        istream.read(reinterpret_cast<char *>(&size), sizeof(size_t));
+            read_growing(obj, size, source, [&](size_t first, size_t count) {
+                if constexpr (is_bool_sequence<T>) {
+                    if (t == PACKED_BOOL_ARRAY || !has_bool_data<T>) return read_bools(obj, count, t == PACKED_BOOL_ARRAY, source, first);
+                    if constexpr (has_bool_data<T>) read_elements(obj, count, swap, source, first);
+                } else {
+                    read_elements(obj, count, swap, source, first);
+                }
+            });
+        } else if constexpr (std::is_same_v<T, CodedStrings>) {
+            read_dictionary(obj, t, swap, source);
+        } else {
+            source.read(&obj, sizeof(T));
+            if (swap) switch_bytes(obj);
+        }
+    }
 
-        if(N < size)throw std::invalid_argument("Size of this array is less than the size of the array being deserialized. Optimal size: " + std::to_string(size));
+    template<typename T>
+    void BinaryConverter::prepare(T &obj, std::size_t size) {
+        if constexpr (std::is_same_v<T, StringTable>) {
+            obj.clear(); // the strings are appended to the arena of the table while they are read.
+            obj.reserve(size, 0);
+        } else if constexpr (is_resizable<T>) {
+            obj.resize(size); // a single allocation, sized from the stored length. Existing capacity is reused.
+        } else if (std::size(obj) < size) {
+            throw std::invalid_argument("Size of this array is less than the size of the array being deserialized. Optimal size: " + std::to_string(size));
+        }
+    }
 
-        switch (t) {
-            case INT_ARRAY:
-                if (typeid(int) != typeid(T))
-                    throw std::invalid_argument("Object type does not match serialized data type (INT ARRAY)");
-                for (int i = 0; i < size; ++i) {
-                    istream.read(reinterpret_cast<char *>(&arr[i]), sizeof(int));
-                }
-                break;
-            case UNSIGNED_INT_ARRAY:
-                if (typeid(unsigned int) != typeid(T))
-                    throw std::invalid_argument(
-                            "Object type does not match serialized data type (UNSIGNED INT ARRAY)");
-                for (int i = 0; i < size; ++i) {
-                    istream.read(reinterpret_cast<char *>(&arr[i]), sizeof(unsigned int));
-                }
-                break;
-            case SHORT_ARRAY:
-                if (typeid(short) != typeid(T))
-                    throw std::invalid_argument("Object type does not match serialized data type (SHORT ARRAY)");
-                for (int i = 0; i < size; ++i) {
-                    istream.read(reinterpret_cast<char *>(&arr[i]), sizeof(short));
-                }
-                break;
-            case UNSIGNED_SHORT_ARRAY:
-                if (typeid(unsigned short) != typeid(T))
-                    throw std::invalid_argument(
-                            "Object type does not match serialized data type (UNSIGNED SHORT ARRAY)");
-                for (int i = 0; i < size; ++i) {
-                    istream.read(reinterpret_cast<char *>(&arr[i]), sizeof(unsigned short));
-                }
-                break;
-            case LONG_ARRAY:
-                if (typeid(long) != typeid(T))
-                    throw std::invalid_argument("Object type does not match serialized data type (LONG ARRAY)");
-                for (int i = 0; i < size; ++i) {
-                    istream.read(reinterpret_cast<char *>(&arr[i]), sizeof(long));
-                }
-                break;
-            case UNSIGNED_LONG_ARRAY:
-                if (typeid(unsigned long) != typeid(T))
-                    throw std::invalid_argument(
-                            "Object type does not match serialized data type (UNSIGNED LONG ARRAY)");
-                for (int i = 0; i < size; ++i) {
-                    istream.read(reinterpret_cast<char *>(&arr[i]), sizeof(unsigned long));
-                }
-                break;
-            case UNSIGNED_LONG_LONG_ARRAY:
-                if (typeid(unsigned long long) != typeid(T))
-                    throw std::invalid_argument(
-                            "Object type does not match serialized data type (UNSIGNED LONG LONG ARRAY)");
-                for (int i = 0; i < size; ++i) {
-                    istream.read(reinterpret_cast<char *>(&arr[i]), sizeof(unsigned long long));
-                }
-                break;
-            case LONG_LONG_ARRAY:
-                if (typeid(long long) != typeid(T))
-                    throw std::invalid_argument("Object type does not match serialized data type (LONG LONG ARRAY)");
-                for (int i = 0; i < size; ++i) {
-                    istream.read(reinterpret_cast<char *>(&arr[i]), sizeof(long long));
-                }
-                break;
-            case FLOAT_ARRAY:
-                if (typeid(float) != typeid(T))
-                    throw std::invalid_argument("Object type does not match serialized data type (FLOAT ARRAY)");
-                for (int i = 0; i < size; ++i) {
-                    istream.read(reinterpret_cast<char *>(&arr[i]), sizeof(float));
-                }
-                break;
-            case DOUBLE_ARRAY:
-                if (typeid(double) != typeid(T))
-                    throw std::invalid_argument("Object type does not match serialized data type (DOUBLE ARRAY)");
-                for (int i = 0; i < size; ++i) {
-                    istream.read(reinterpret_cast<char *>(&arr[i]), sizeof(double));
-                }
-                break;
-            case LONG_DOUBLE_ARRAY:
-                if (typeid(long double) != typeid(T))
-                    throw std::invalid_argument("Object type does not match serialized data type (LONG DOUBLE ARRAY)");
-                for (int i = 0; i < size; ++i) {
-                    istream.read(reinterpret_cast<char *>(&arr[i]), sizeof(long double));
-                }
-                break;
-            case STRING_ARRAY:
-                if constexpr (std::is_same_v<T, std::string>) {
-                    size_t string_size;
-                    for (int i = 0; i < size; ++i) {
-                        istream.read(reinterpret_cast<char *>(&string_size), sizeof(size_t));
-
-                        char temp[string_size + 1];
-                        istream.read(reinterpret_cast<char *>(&temp), static_cast<std::streamsize>(string_size));
-                        temp[string_size] = '\0';
-
-                        arr[i] = std::string(temp);
+    template<typename T, typename Source, typename Read>
+    void BinaryConverter::read_growing(T &obj, std::size_t size, Source &source, Read read) {
+        // a multiple of 8 elements, so packed bools are split at byte boundaries.
+        constexpr size_t step = std::max<size_t>(growth_step / sizeof(element_t<T>) / 8, 1) * 8;
+        if constexpr ((is_resizable<T> || std::is_same_v<T, StringTable>) && !requires { source.remaining(); }) {
+            if (size > step) {
+                for (size_t first = 0; first < size && source_ok(source); first += step) {
+                    const size_t count = std::min(step, size - first);
+                    if constexpr (std::is_same_v<T, StringTable>) {
+                        if (first == 0) prepare(obj, count); // the strings are appended, the table grows by itself.
+                    } else {
+                        obj.resize(first + count);
                     }
-                } else
-                    throw std::invalid_argument("Object type does not match serialized data type (ARRAY OF STRINGS)");
-                break;
-            case CHAR_ARRAY:
-                if (typeid(char) != typeid(T))
-                    throw std::invalid_argument("Object type does not match serialized data type (CHAR ARRAY)");
-                for (int i = 0; i < size; ++i) {
-                    istream.read(reinterpret_cast<char *>(&arr[i]), sizeof(char));
+                    read(first, count);
                 }
-                break;
-            case UNSIGNED_CHAR_ARRAY:
-                if (typeid(unsigned char) != typeid(T))
-                    throw std::invalid_argument(
-                            "Object type does not match serialized data type (UNSIGNED CHAR ARRAY)");
-                for (int i = 0; i < size; ++i) {
-                    istream.read(reinterpret_cast<char *>(&arr[i]), sizeof(unsigned char));
-                }
-                break;
-            case BOOL_ARRAY:
-                if (typeid(bool) != typeid(T))
-                    throw std::invalid_argument("Object type does not match serialized data type (BOOL ARRAY)");
-                for (int i = 0; i < size; ++i) {
-                    istream.read(reinterpret_cast<char *>(&arr[i]), sizeof(bool));
-                }
-                break;
-            default:
-                throw std::invalid_argument("Data type not accepted");
+                return;
+            }
         }
-        if (st != sts) {
-            if constexpr (!std::is_same_v<T, std::string> && !std::is_same_v<T, char> &&
-                          !std::is_same_v<T, unsigned char> && !std::is_same_v<T, bool>) {
-                for (int i = 0; i < size; ++i) {
-                    switch_bytes(arr[i]);
-                }
+        prepare(obj, size);
+        read(0, size);
+    }
+
+    template<typename Source>
+    std::uint64_t BinaryConverter::read_varint(Source &source) {
+        unsigned char bytes[VarintCoder::max_size];
+        for (size_t i = 0; i < VarintCoder::max_size; ++i) {
+            source.read(bytes + i, 1);
+            if (bytes[i] < 0x80) {
+                const unsigned char *in = bytes;
+                std::uint64_t value = 0;
+                VarintCoder::decode(in, bytes + i + 1, value);
+                return value;
             }
         }
+        throw std::runtime_error("Malformed varint");
     }
 
-    template<typename T>
-    void BinaryConverter::serialize(T &, std::ostream &) {
-        throw std::runtime_error("Type not supported"); // If a not supported data type is inputted. It throws an error.
+    template<typename Source>
+    void BinaryConverter::discard(std::size_t count, Source &source) {
+        if constexpr (requires { source.skip(count); }) {
+            source.skip(count);
+        } else if constexpr (requires { source.take(count); }) {
+            source.take(count);
+        } else {
+            unsigned char chunk[4096];
+            for (std::size_t n; count != 0; count -= n) {
+                n = std::min(count, sizeof(chunk));
+                source.read(chunk, n);
+            }
+        }
     }
 
-    template<>
-    inline void BinaryConverter::serialize<int>(int &obj, std::ostream &ostream) {
-        type t = type::INT;
-        system_type st = detect_system_type();
+    template<typename Source>
+    void BinaryConverter::skip_payload(type t, bool swap, Source &source) {
+        const auto read_size = [&] {
+            size_t size;
+            source.read(&size, sizeof(size_t));
+            return swap ? switch_bytes(size) : size;
+        };
+        if (!is_known_type(t)) throw std::invalid_argument("Data type not accepted");
+        if (t == STRING_ARRAY) {
+            const size_t count = read_size();
+            for (size_t i = 0; i < count; ++i) discard(read_size(), source);
+        } else if (t == COLUMNS) {
+            discard(sizeof(std::uint32_t) + sizeof(size_t), source); // the signature and the row count.
+            discard(read_size() * (1 + sizeof(size_t)), source); // the directory.
+            discard(read_size(), source); // the columns.
+        } else if (t == STRUCT) {
+            discard(sizeof(std::uint32_t), source); // the signature, followed by the length of the fields.
+            discard(read_varint(source), source);
+        } else if (t == VARINT || t == ZIGZAG_VARINT) {
+            read_varint(source);
+        } else if (t == VARINT_ARRAY || t == ZIGZAG_VARINT_ARRAY) {
+            read_varint(source);
+            discard(read_varint(source), source); // the byte length of the varints.
+        } else if (t == DICTIONARY_STRING_ARRAY) {
+            const size_t count = read_size(), unique = read_size();
+            unsigned char width;
+            source.read(&width, 1);
+            for (size_t i = 0; i < unique; ++i) discard(read_size(), source);
+            if (width > 4 || count > std::numeric_limits<size_t>::max() / 4) throw std::runtime_error("Corrupted length prefix");
+            discard(count * width, source); // the codes.
+        } else if (is_series(t)) {
+            read_size(); // the count, then the plain type flag and the byte length of the series.
+            discard(1, source);
+            discard(read_size(), source);
+        } else if (t == ZONED_ARRAY) {
+            const size_t count = read_size();
+            unsigned char plain;
+            source.read(&plain, 1);
+            const size_t block = read_size();
+            const auto element = static_cast<type>(plain);
+            if (element < INT_ARRAY || element > DOUBLE_ARRAY || count > std::numeric_limits<size_t>::max() / 16 || (count != 0 && block == 0))
+                throw std::runtime_error("Corrupted zone map");
+            // a zone is larger than an element, so the zones alone can overflow with a block size of 1.
+            const size_t zones = count == 0 ? 0 : (count - 1) / block + 1, elements = payload_bytes(element, count);
+            if (zones > (std::numeric_limits<size_t>::max() - elements) / zone_size(element)) throw std::runtime_error("Corrupted zone map");
+            discard(zones * zone_size(element) + elements, source);
+        } else if (t == STRING || t >= INT_ARRAY) {
+            const size_t count = read_size();
+            if (count > std::numeric_limits<size_t>::max() / 16) throw std::runtime_error("Corrupted length prefix");
+            discard(payload_bytes(t, count), source);
+        } else {
+            discard(element_size(t), source);
+        }
+    }
+
+    inline type BinaryConverter::skip(std::istream &istream) {
+        char header[header_size];
+        istream.read(header, header_size);
+        if (!istream) throw std::runtime_error("Unexpected end of stream");
+        const auto t = static_cast<type>(header[1]);
+        StreamSource source{istream};
+        skip_payload(t, static_cast<system_type>(header[0]) != detect_system_type(), source);
+        return t;
+    }
 
-        ostream.write(reinterpret_cast<char *>(&st), 1); // adds the system type flag.
-        ostream.write(reinterpret_cast<char *>(&t), 1); // adds the data type flag.
-        ostream.write(reinterpret_cast<char *>(&obj), sizeof(int)); // serializes the data.
+    inline std::size_t BinaryConverter::skip(std::span<const std::byte> buffer) {
+        ByteReader reader(buffer);
+        char header[header_size];
+        reader.read(header, header_size);
+        skip_payload(static_cast<type>(header[1]), static_cast<system_type>(header[0]) != detect_system_type(), reader);
+        return buffer.size() - reader.remaining();
     }
 
-    template<>
-    inline void BinaryConverter::serialize<unsigned int>(unsigned int &obj, std::ostream &ostream) {
-        type t = type::UNSIGNED_INT;
-        system_type st = detect_system_type();
+    template<typename T, typename Source>
+    void BinaryConverter::read_varints(T &obj, Source &source) {
+        if constexpr (is_sequence<T>) {
+            const size_t size = read_varint(source);
+            const size_t bytes = read_varint(source);
+            if (size > bytes) throw std::runtime_error("Malformed varint array"); // every varint takes a byte at least.
 
-        ostream.write(reinterpret_cast<char *>(&st), 1);
-        ostream.write(reinterpret_cast<char *>(&t), 1);
-        ostream.write(reinterpret_cast<char *>(&obj), sizeof(unsigned int));
+            size_t decoded = 0;
+            if constexpr (requires { source.take(bytes); }) {
+                // the bytes are already in memory, they are decoded where they are.
+                const auto *in = reinterpret_cast<const unsigned char *>(source.take(bytes));
+                prepare(obj, size);
+                if (VarintCoder::decode_array(in, bytes, std::data(obj), size, decoded) != bytes || decoded != size)
+                    throw std::runtime_error("Malformed varint array");
+            } else {
+                if constexpr (!is_resizable<T>) prepare(obj, size);
+                unsigned char chunk[4096]; // a varint that is cut at the end of a chunk is moved to the front.
+                size_t buffered = 0;
+                size_t remaining = bytes;
+                while (decoded < size && source_ok(source)) {
+                    const size_t count = std::min(sizeof(chunk) - buffered, remaining);
+                    source.read(chunk + buffered, count);
+                    remaining -= count;
+                    buffered += count;
+                    // the container grows with the varints that arrived, a varint takes a byte at least.
+                    const size_t limit = std::min(size - decoded, buffered);
+                    if constexpr (is_resizable<T>) {
+                        if (std::size(obj) < decoded + limit) obj.resize(decoded + limit);
+                    }
+                    size_t n;
+                    const size_t used = VarintCoder::decode_array(chunk, buffered, std::data(obj) + decoded, limit, n);
+                    if (n == 0 && count == 0) break;
+                    decoded += n;
+                    buffered -= used;
+                    std::memmove(chunk, chunk + used, buffered);
+                }
+                if constexpr (is_resizable<T>) obj.resize(decoded); // also drops what a reused container held.
+                if (decoded != size || remaining != 0 || buffered != 0) throw std::runtime_error("Malformed varint array");
+            }
+        } else {
+            obj = VarintCoder::narrow<T>(read_varint(source));
+        }
     }
 
-    template<>
-    inline void BinaryConverter::serialize<short>(short &obj, std::ostream &ostream) {
-        type t = type::SHORT;
-        system_type st = detect_system_type();
+    template<typename T, typename Source>
+    void BinaryConverter::read_series(T &obj, type t, bool swap, Source &source) {
+        size_t size, bytes;
+        unsigned char plain;
+        source.read(&size, sizeof(size_t));
+        source.read(&plain, 1);
+        source.read(&bytes, sizeof(size_t));
+        if (swap) {
+            switch_bytes(size); // the prefixes are native, the series itself is little endian everywhere.
+            switch_bytes(bytes);
+        }
+        if (plain != type_tag_v<T>)
+            throw std::invalid_argument(std::string("Object type does not match serialized data type (") + type_name(type_tag_v<T>) + ")");
+        // checked before anything is allocated: every block of residuals takes a byte at least, and 64 bits per
+        // value at most.
+        if (size > std::numeric_limits<size_t>::max() / 16 || bytes > SeriesCoder::max_size(size) ||
+            (size > 2 && (size - 2) / SeriesCoder::block_size > bytes))
+            throw std::runtime_error("Malformed time series array");
 
-        ostream.write(reinterpret_cast<char *>(&st), 1);
-        ostream.write(reinterpret_cast<char *>(&t), 1);
-        ostream.write(reinterpret_cast<char *>(&obj), sizeof(short));
+        std::vector<unsigned char> scratch;
+        const unsigned char *in;
+        if constexpr (requires { source.take(bytes); }) {
+            in = reinterpret_cast<const unsigned char *>(source.take(bytes)); // decoded where it is.
+        } else {
+            read_growing(scratch, bytes, source, [&](size_t first, size_t count) { source.read(scratch.data() + first, count); });
+            if (scratch.size() != bytes) return; // the stream ran dry, the caller finds it failed.
+            in = scratch.data();
+        }
+        prepare(obj, size); // the bytes have arrived, and they bound the count by the checks above.
+        if constexpr (has_xor_encoding<T>) {
+            if (t == XOR_FLOAT_ARRAY) return SeriesCoder::decode_xor(in, bytes, std::data(obj), size);
+        }
+        if constexpr (has_delta_encoding<T>) {
+            if (t != XOR_FLOAT_ARRAY) return SeriesCoder::decode_delta(in, bytes, std::data(obj), size, t == DELTA_ARRAY ? 1 : 2);
+        }
+        throw std::invalid_argument(std::string("Object type does not match serialized data type (") + type_name(type_tag_v<T>) + ")");
     }
 
-    template<>
-    inline void BinaryConverter::serialize<unsigned short>(unsigned short &obj, std::ostream &ostream) {
-        type t = type::UNSIGNED_SHORT;
-        system_type st = detect_system_type();
+    template<typename T, typename Source>
+    void BinaryConverter::read_zoned(T &obj, bool swap, Source &source) {
+        size_t size, block;
+        unsigned char plain;
+        source.read(&size, sizeof(size_t));
+        source.read(&plain, 1);
+        source.read(&block, sizeof(size_t));
+        if (swap) {
+            switch_bytes(size);
+            switch_bytes(block);
+        }
+        if (plain != type_tag_v<T>)
+            throw std::invalid_argument(std::string("Object type does not match serialized data type (") + type_name(type_tag_v<T>) + ")");
+        if (size > std::numeric_limits<size_t>::max() / 16 || (size != 0 && block == 0)) throw std::runtime_error("Corrupted zone map");
+        const size_t zones = size == 0 ? 0 : (size - 1) / block + 1;
+        if (zones > std::numeric_limits<size_t>::max() / zone_size(type_tag_v<T>)) throw std::runtime_error("Corrupted zone map");
+        discard(zones * zone_size(type_tag_v<T>), source); // a full read needs no zones.
+        if constexpr (requires { source.remaining(); }) {
+            if (size > source.remaining() / sizeof(element_t<T>)) throw std::runtime_error("Unexpected end of buffer");
+        }
+        read_growing(obj, size, source, [&](size_t first, size_t count) { read_elements(obj, count, swap, source, first); });
+    }
 
-        ostream.write(reinterpret_cast<char *>(&st), 1);
-        ostream.write(reinterpret_cast<char *>(&t), 1);
-        ostream.write(reinterpret_cast<char *>(&obj), sizeof(unsigned short));
+    template<typename T, typename Source>
+    void BinaryConverter::read_dictionary(T &obj, type t, bool swap, Source &source) {
+        const auto read_size = [&] {
+            size_t size;
+            source.read(&size, sizeof(size_t));
+            return swap ? switch_bytes(size) : size;
+        };
+        const size_t count = read_size();
+        if (count > std::numeric_limits<size_t>::max() / 16) throw std::runtime_error("Corrupted length prefix");
+        if constexpr (std::is_same_v<T, CodedStrings>) {
+            obj.clear();
+            if (t == STRING_ARRAY) { // plain strings, the dictionary is built while they are read.
+                std::unordered_map<std::string, std::uint32_t> codes;
+                std::string string;
+                for (size_t i = 0; i < count; ++i) {
+                    const size_t length = read_size();
+                    check_string_length(length);
+                    string.resize(length);
+                    source.read(string.data(), length);
+                    const auto [position, added] = codes.try_emplace(string, static_cast<std::uint32_t>(obj.strings.size()));
+                    if (added) obj.strings.push_back(string);
+                    obj.indices.push_back(position->second);
+                }
+                return;
+            }
+        }
+        const size_t unique = read_size();
+        unsigned char width;
+        source.read(&width, 1);
+        if ((width != 1 && width != 2 && width != 4) || unique > count) throw std::runtime_error("Malformed dictionary string array");
+        if constexpr (requires { source.remaining(); }) {
+            if (count * width > source.remaining()) throw std::runtime_error("Unexpected end of buffer"); // before allocating.
+        }
+
+        StringTable scratch;
+        StringTable &dictionary = [&]() -> StringTable & {
+            if constexpr (std::is_same_v<T, CodedStrings>) return obj.strings;
+            else return scratch;
+        }();
+        dictionary.reserve(std::min(unique, growth_step / sizeof(size_t)), 0); // larger dictionaries grow as they arrive.
+        for (size_t i = 0; i < unique; ++i) {
+            const size_t length = read_size();
+            check_string_length(length);
+            source.read(dictionary.append(length), length);
+        }
+
+        auto &destination = [&]() -> auto & {
+            if constexpr (std::is_same_v<T, CodedStrings>) return obj.indices;
+            else return obj;
+        }();
+        unsigned char chunk[4096]; // the codes go through a small buffer, checked against the dictionary.
+        const size_t per_chunk = sizeof(chunk) / width;
+        read_growing(destination, count, source, [&](size_t first, size_t codes) {
+            for (size_t i = first; i < first + codes; i += per_chunk) {
+                const size_t n = std::min(per_chunk, first + codes - i);
+                source.read(chunk, n * width);
+                for (size_t j = 0; j < n; ++j) {
+                    std::uint32_t code;
+                    if (width == 1) {
+                        code = chunk[j];
+                    } else if (width == 2) {
+                        std::uint16_t narrow;
+                        std::memcpy(&narrow, chunk + j * 2, 2);
+                        code = swap ? switch_bytes(narrow) : narrow;
+                    } else {
+                        std::memcpy(&code, chunk + j * 4, 4);
+                        if (swap) switch_bytes(code);
+                    }
+                    if (code >= unique) throw std::runtime_error("Malformed dictionary string array");
+                    if constexpr (std::is_same_v<T, CodedStrings>) obj.indices[i + j] = code;
+                    else if constexpr (std::is_same_v<T, StringTable>) obj.push_back(dictionary[code]);
+                    else obj[i + j].assign(dictionary[code]);
+                }
+            }
+        });
     }
 
-    template<>
-    inline void BinaryConverter::serialize<long>(long &obj, std::ostream &ostream) {
-        type t = type::LONG;
-        system_type st = detect_system_type();
+    template<typename T>
+    std::size_t BinaryConverter::fields_size(const T &obj) {
+        if constexpr (Reflection::is_packed<T>()) {
+            return sizeof(T);
+        } else {
+            std::size_t size = 0;
+            const auto add = [&size](const auto &field) {
+                if constexpr (is_struct<std::remove_cvref_t<decltype(field)>>) size += fields_size(field);
+                else size += payload_size(field);
+            };
+            std::apply([&add](const auto &...field) { (add(field), ...); }, obj.ces_fields());
+            return size;
+        }
+    }
+
+    template<typename T>
+    std::byte *BinaryConverter::encode_fields(const T &obj, std::byte *out) {
+        if constexpr (Reflection::is_packed<T>()) {
+            if (Reflection::in_memory_order(obj)) { // the fields are the struct, one copy for all of them.
+                std::memcpy(out, &obj, sizeof(T));
+                return out + sizeof(T);
+            }
+        }
+        const auto write = [&out](const auto &field) {
+            if constexpr (is_struct<std::remove_cvref_t<decltype(field)>>) out = encode_fields(field, out);
+            else out = encode_payload(field, out);
+        };
+        std::apply([&write](const auto &...field) { (write(field), ...); }, obj.ces_fields());
+        return out;
+    }
 
-        ostream.write(reinterpret_cast<char *>(&st), 1);
-        ostream.write(reinterpret_cast<char *>(&t), 1);
-        ostream.write(reinterpret_cast<char *>(&obj), sizeof(long));
+    template<typename T, typename Source>
+    void BinaryConverter::read_fields(T &obj, bool swap, Source &source) {
+        if constexpr (Reflection::is_packed<T>()) {
+            if (!swap && Reflection::in_memory_order(obj)) {
+                source.read(&obj, sizeof(T));
+                return;
+            }
+        }
+        const auto read = [swap, &source](auto &field) {
+            using Field = std::remove_cvref_t<decltype(field)>;
+            if constexpr (is_struct<Field>) read_fields(field, swap, source);
+            else read_payload(field, type_tag_v<Field>, swap, source);
+        };
+        std::apply([&read](auto &...field) { (read(field), ...); }, obj.ces_fields());
     }
 
-    template<>
-    inline void BinaryConverter::serialize<unsigned long>(unsigned long &obj, std::ostream &ostream) {
-        type t = type::UNSIGNED_LONG;
-        system_type st = detect_system_type();
+    template<typename T, typename Source>
+    void BinaryConverter::read_elements(T &obj, std::size_t size, bool swap, Source &source, std::size_t first) {
+        if constexpr (type_tag_v<T> == STRING_ARRAY) {
+            size_t string_size;
+            for (size_t i = first; i < first + size; ++i) {
+                source.read(&string_size, sizeof(size_t));
+                if (swap) switch_bytes(string_size);
+                check_string_length(string_size);
 
-        ostream.write(reinterpret_cast<char *>(&st), 1);
-        ostream.write(reinterpret_cast<char *>(&t), 1);
-        ostream.write(reinterpret_cast<char *>(&obj), sizeof(unsigned long));
+                if constexpr (std::is_same_v<T, StringTable>) {
+                    source.read(obj.append(string_size), string_size);
+                } else {
+                    obj[i].resize(string_size); // reads straight into the storage of the string, no temporary.
+                    source.read(obj[i].data(), string_size);
+                }
+            }
+        } else {
+            // the elements are stored contiguously, so a single read fills the whole destination.
+            source.read(std::data(obj) + first, size * sizeof(element_t<T>));
+            if (swap) ByteSwapper::swap_in_place(std::data(obj) + first, size);
+        }
     }
 
-    template<>
-    inline void BinaryConverter::serialize<long long>(long long &obj, std::ostream &ostream) {
-        type t = type::LONG_LONG;
-        system_type st = detect_system_type();
+    template<typename T, typename Source>
+    void BinaryConverter::read_bools(T &obj, std::size_t size, bool packed, Source &source, std::size_t first) {
+        unsigned char chunk[4096]; // the stored bytes go through a small buffer before they become bools.
+        const size_t per_chunk = packed ? sizeof(chunk) * 8 : sizeof(chunk);
+        for (size_t i = first; i < first + size; i += per_chunk) {
+            const size_t count = std::min(per_chunk, first + size - i);
+            if (packed) {
+                source.read(chunk, BitPacker::packed_size(count));
+                if constexpr (has_bool_data<T>) {
+                    BitPacker::unpack(chunk, count, std::data(obj) + i);
+                } else {
+                    for (size_t j = 0; j < count; ++j) obj[i + j] = (chunk[j / 8] >> (j % 8)) & 1;
+                }
+            } else {
+                source.read(chunk, count); // std::vector<bool> and std::bitset have no bool storage to read into.
+                for (size_t j = 0; j < count; ++j) obj[i + j] = chunk[j] != 0;
+            }
+        }
+    }
 
-        ostream.write(reinterpret_cast<char *>(&st), 1);
-        ostream.write(reinterpret_cast<char *>(&t), 1);
-        ostream.write(reinterpret_cast<char *>(&obj), sizeof(long long));
+    template<typename T>
+    void BinaryConverter::write_bools(const T &obj, std::byte *out) {
+        auto *bytes = reinterpret_cast<unsigned char *>(out);
+        const auto &values = [&]() -> const auto & {
+            if constexpr (type_tag_v<T> == PACKED_BOOL_ARRAY && requires { obj.values; }) return obj.values;
+            else return obj;
+        }();
+        using Values = std::remove_cvref_t<decltype(values)>;
+        const size_t size = std::size(values);
+        if constexpr (requires { { std::data(values) } -> std::convertible_to<const bool *>; }) {
+            BitPacker::pack(std::data(values), size, bytes);
+        } else {
+            std::memset(bytes, 0, BitPacker::packed_size(size));
+            for (size_t i = 0; i < size; ++i) {
+                if constexpr (requires(const Values &v) { v.test(i); }) bytes[i / 8] |= static_cast<unsigned char>(values.test(i) << (i % 8));
+                else bytes[i / 8] |= static_cast<unsigned char>(static_cast<bool>(values[i]) << (i % 8));
+            }
+        }
     }
 
-    template<>
-    inline void BinaryConverter::serialize<unsigned long long>(unsigned long long &obj, std::ostream &ostream) {
-        type t = type::UNSIGNED_LONG_LONG;
-        system_type st = detect_system_type();
+    inline void BinaryConverter::check_string_length(std::size_t length) {
+        if (length > string_length_limit.load(std::memory_order_relaxed))
+            throw std::invalid_argument("String length exceeds the maximum string length: " + std::to_string(length));
+    }
 
-        ostream.write(reinterpret_cast<char *>(&st), 1);
-        ostream.write(reinterpret_cast<char *>(&t), 1);
-        ostream.write(reinterpret_cast<char *>(&obj), sizeof(unsigned long long));
+    inline void BinaryConverter::set_max_string_length(std::size_t length) {
+        string_length_limit.store(length, std::memory_order_relaxed);
     }
 
-    template<>
-    inline void BinaryConverter::serialize<float>(float &obj, std::ostream &ostream) {
-        type t = type::FLOAT;
-        system_type st = detect_system_type();
+    inline std::size_t BinaryConverter::max_string_length() {
+        return string_length_limit.load(std::memory_order_relaxed);
+    }
 
-        ostream.write(reinterpret_cast<char *>(&st), 1);
-        ostream.write(reinterpret_cast<char *>(&t), 1);
-        ostream.write(reinterpret_cast<char *>(&obj), sizeof(float));
+    inline std::byte *BinaryConverter::write_header(type t, std::byte *out) {
+        out[0] = static_cast<std::byte>(detect_system_type()); // adds the system type flag.
+        out[1] = static_cast<std::byte>(t); // adds the data type flag.
+        return out + header_size;
     }
 
-    template<>
-    inline void BinaryConverter::serialize<double>(double &obj, std::ostream &ostream) {
-        constexpr type t = type::DOUBLE;
-        system_type st = detect_system_type();
+    template<typename T>
+    std::size_t BinaryConverter::size_of(const T &obj) {
+        return header_size + payload_size(obj);
+    }
 
-        ostream.write(reinterpret_cast<char *>(&st), 1);
-        ostream.write(reinterpret_cast<const char *>(&t), 1);
-        ostream.write(reinterpret_cast<char *>(&obj), sizeof(double));
+    template<typename T>
+    std::size_t BinaryConverter::payload_size(const T &obj) {
+        if constexpr (is_self_encoding<T>) {
+            return obj.payload_size();
+        } else if constexpr (is_varint(type_tag_v<T>)) {
+            const auto &value = obj.value;
+            if constexpr (is_sequence<std::remove_cvref_t<decltype(value)>>) {
+                const size_t bytes = VarintCoder::encoded_size(std::data(value), std::size(value));
+                return VarintCoder::size(std::size(value)) + VarintCoder::size(bytes) + bytes;
+            } else {
+                return VarintCoder::size(VarintCoder::widen(value));
+            }
+        } else if constexpr (is_struct<T>) {
+            const std::size_t bytes = fields_size(obj);
+            return sizeof(std::uint32_t) + VarintCoder::size(bytes) + bytes;
+        } else if constexpr (is_sequence<T>) {
+            std::size_t size = sizeof(size_t); // strings and arrays are prefixed by their length.
+            if constexpr (type_tag_v<T> == STRING_ARRAY) {
+                for (const auto &elem: obj) size += sizeof(size_t) + elem.size();
+            } else if constexpr (type_tag_v<T> == PACKED_BOOL_ARRAY) {
+                size += BitPacker::packed_size(std::size(obj));
+            } else {
+                size += std::size(obj) * sizeof(element_t<T>);
+            }
+            return size;
+        } else {
+            return sizeof(T);
+        }
     }
 
-    template<>
-    inline void BinaryConverter::serialize<long double>(long double &obj, std::ostream &ostream) {
-        constexpr type t = type::LONG_DOUBLE;
-        system_type st = detect_system_type();
+    template<typename T>
+    type BinaryConverter::type_of(const T &obj) {
+        if constexpr (requires { { obj.type_flag() } -> std::same_as<type>; }) return obj.type_flag();
+        else return type_tag_v<T>;
+    }
 
-        ostream.write(reinterpret_cast<char *>(&st), 1);
-        ostream.write(reinterpret_cast<const char *>(&t), 1);
-        ostream.write(reinterpret_cast<char *>(&obj), sizeof(long double));
+    template<typename T>
+    std::byte *BinaryConverter::encode(const T &obj, std::byte *out) {
+        return encode_payload(obj, write_header(type_of(obj), out));
     }
 
-    template<>
-    inline void BinaryConverter::serialize<std::string>(std::string &obj, std::ostream &ostream) {
-        const size_t size = obj.size();
-        constexpr type t = type::STRING;
-        system_type st = detect_system_type();
+    template<typename T>
+    std::byte *BinaryConverter::encode_payload(const T &obj, std::byte *out) {
+        if constexpr (is_self_encoding<T>) {
+            return obj.encode_payload(out);
+        } else if constexpr (is_varint(type_tag_v<T>)) {
+            const auto &value = obj.value;
+            auto *bytes = reinterpret_cast<unsigned char *>(out);
+            if constexpr (is_sequence<std::remove_cvref_t<decltype(value)>>) {
+                const size_t size = std::size(value);
+                bytes = VarintCoder::encode(size, bytes); // the count and the byte length, so a reader can skip it.
+                bytes = VarintCoder::encode(VarintCoder::encoded_size(std::data(value), size), bytes);
+                bytes = VarintCoder::encode_array(std::data(value), size, bytes);
+            } else {
+                bytes = VarintCoder::encode(VarintCoder::widen(value), bytes);
+            }
+            return reinterpret_cast<std::byte *>(bytes);
+        } else if constexpr (is_struct<T>) {
+            const std::uint32_t signature = Reflection::signature<T>();
+            std::memcpy(out, &signature, sizeof(signature));
+            auto *length = reinterpret_cast<unsigned char *>(out + sizeof(signature));
+            out = reinterpret_cast<std::byte *>(VarintCoder::encode(fields_size(obj), length));
+            return encode_fields(obj, out);
+        } else if constexpr (is_sequence<T>) {
+            const size_t size = std::size(obj);
+            std::memcpy(out, &size, sizeof(size_t)); // adds the size of the string or array.
+            out += sizeof(size_t);
+            if constexpr (type_tag_v<T> == STRING_ARRAY) {
+                for (const auto &elem: obj) {
+                    const size_t elem_size = elem.size();
+                    std::memcpy(out, &elem_size, sizeof(size_t));
+                    if (elem_size != 0) std::memcpy(out + sizeof(size_t), elem.data(), elem_size);
+                    out += sizeof(size_t) + elem_size;
+                }
+            } else if constexpr (type_tag_v<T> == PACKED_BOOL_ARRAY) {
+                write_bools(obj, out);
+                out += BitPacker::packed_size(size);
+            } else if constexpr (is_bit_vector<T>) {
+                for (const bool elem: obj) *out++ = static_cast<std::byte>(elem);
+            } else {
+                const size_t bytes = size * sizeof(element_t<T>); // the elements are contiguous, one copy for all of them.
+                if (bytes != 0) std::memcpy(out, std::data(obj), bytes);
+                out += bytes;
+            }
+        } else {
+            std::memcpy(out, &obj, sizeof(T)); // serializes the data.
+            out += sizeof(T);
+        }
+        return out;
+    }
 
-        ostream.write(reinterpret_cast<char *>(&st), 1);
-        ostream.write(reinterpret_cast<const char *>(&t), 1);
-        ostream.write(reinterpret_cast<const char *>(&size), sizeof(size));
-        ostream.write(const_cast<char *>(obj.c_str()), static_cast<std::streamsize>(size));
+    template<typename T>
+    void BinaryConverter::serialize(const T &obj, ByteBuffer &buffer) {
+        const Stats::Timer timer;
+        const std::size_t size = size_of(obj);
+        encode(obj, buffer.grow(size));
+        Stats::record_serialize(type_of(obj), size, timer);
     }
 
-    template<>
-    inline void BinaryConverter::serialize<char>(char &obj, std::ostream &ostream) {
-        constexpr type t = type::CHAR;
-        system_type st = detect_system_type();
+    template<typename T>
+    std::size_t BinaryConverter::serialize_into(const T &obj, std::span<std::byte> buffer) {
+        const Stats::Timer timer;
+        const std::size_t size = size_of(obj);
+        if (buffer.size() < size)
+            throw std::invalid_argument("Buffer is too small for the serialized object. Required size: " + std::to_string(size));
+        encode(obj, buffer.data());
+        Stats::record_serialize(type_of(obj), size, timer);
+        return size;
+    }
 
-        ostream.write(reinterpret_cast<char *>(&st), 1);
-        ostream.write(reinterpret_cast<const char *>(&t), 1);
-        ostream.write(reinterpret_cast<char *>(&obj), sizeof(char));
+    template<typename T>
+    void BinaryConverter::serialize(const T &obj, std::ostream &ostream) {
+        const Stats::Timer timer;
+        write_to(obj, ostream);
+        if constexpr (Stats::enabled) Stats::record_serialize(type_of(obj), size_of(obj), timer);
     }
 
-    template<>
-    inline void BinaryConverter::serialize<unsigned char>(unsigned char &obj, std::ostream &ostream) {
-        constexpr type t = type::UNSIGNED_CHAR;
-        system_type st = detect_system_type();
+    template<typename T>
+    void BinaryConverter::write_to(const T &obj, std::ostream &ostream) {
+        if constexpr (is_self_encoding<T> || is_varint(type_tag_v<T>) || is_struct<T> || (is_sequence<T> && !is_contiguous<T>)) {
+            // the payload is not a copy of contiguous memory, so it is encoded first. Small ones on the stack.
+            const std::size_t size = size_of(obj);
+            std::byte small[256];
+            ByteBuffer buffer;
+            std::byte *bytes = size <= sizeof(small) ? small : buffer.grow(size);
+            encode(obj, bytes);
+            ostream.write(reinterpret_cast<const char *>(bytes), static_cast<std::streamsize>(size));
+        } else if constexpr (is_sequence<T>) {
+            std::byte header[header_size + sizeof(size_t)];
+            const size_t size = std::size(obj);
+            std::memcpy(write_header(type_tag_v<T>, header), &size, sizeof(size_t));
+            ostream.write(reinterpret_cast<const char *>(header), sizeof(header));
+            ostream.write(reinterpret_cast<const char *>(std::data(obj)),
+                          static_cast<std::streamsize>(size * sizeof(element_t<T>))); // the payload is written in place.
+        } else {
+            std::byte bytes[header_size + sizeof(T)];
+            encode(obj, bytes);
+            ostream.write(reinterpret_cast<const char *>(bytes), sizeof(bytes)); // header and data in a single write.
+        }
+    }
 
-        ostream.write(reinterpret_cast<char *>(&st), 1);
-        ostream.write(reinterpret_cast<const char *>(&t), 1);
-        ostream.write(reinterpret_cast<char *>(&obj), sizeof(unsigned char));
+    template<typename T, std::size_t N>
+    void BinaryConverter::serialize(const T (&arr)[N], std::ostream &ostream) {
+        serialize<T[N]>(arr, ostream);
     }
 
-    template<>
-    inline void BinaryConverter::serialize<bool>(bool &obj, std::ostream &ostream) {
-        constexpr type t = type::BOOL;
-        system_type st = detect_system_type();
+    template<typename T>
+    void BinaryConverter::deserialize(T &obj, std::istream &istream) {
+        const Stats::Timer timer;
+        StreamSource source{istream};
+        const bool swapped = Stats::enabled && istream.peek() != detect_system_type();
+        read_value(obj, source);
+        Stats::record_deserialize(type_tag_v<T>, source.consumed, swapped, timer);
+    }
 
-        ostream.write(reinterpret_cast<char *>(&st), 1);
-        ostream.write(reinterpret_cast<const char *>(&t), 1);
-        ostream.write(reinterpret_cast<char *>(&obj), sizeof(bool));
+    template<typename T, std::size_t N>
+    void BinaryConverter::deserialize(T (&arr)[N], std::istream &istream) {
+        deserialize<T[N]>(arr, istream);
     }
 
     template<typename T>
-    type BinaryConverter::find_type(T) {
-        if (typeid(T) == typeid(int))return INT_ARRAY;
-        else if (typeid(T) == typeid(unsigned int)) return UNSIGNED_INT_ARRAY;
-        else if (typeid(T) == typeid(short)) return SHORT_ARRAY;
-        else if (typeid(T) == typeid(unsigned short)) return UNSIGNED_SHORT_ARRAY;
-        else if (typeid(T) == typeid(long)) return LONG_ARRAY;
-        else if (typeid(T) == typeid(unsigned long)) return UNSIGNED_LONG_ARRAY;
-        else if (typeid(T) == typeid(long long)) return LONG_LONG_ARRAY;
-        else if (typeid(T) == typeid(unsigned long long)) return UNSIGNED_LONG_LONG_ARRAY;
-        else if (typeid(T) == typeid(float)) return FLOAT_ARRAY;
-        else if (typeid(T) == typeid(double)) return DOUBLE_ARRAY;
-        else if (typeid(T) == typeid(long double)) return LONG_DOUBLE_ARRAY;
-        else if (typeid(T) == typeid(std::string)) return STRING_ARRAY;
-        else if (typeid(T) == typeid(char)) return CHAR_ARRAY;
-        else if (typeid(T) == typeid(unsigned char)) return UNSIGNED_CHAR_ARRAY;
-        else if (typeid(T) == typeid(bool)) return BOOL_ARRAY;
-        else throw std::invalid_argument("Unsupported array type");
+    std::size_t BinaryConverter::deserialize(T &obj, std::span<const std::byte> buffer) {
+        const Stats::Timer timer;
+        ByteReader reader(buffer);
+        read_value(obj, reader);
+        const std::size_t consumed = buffer.size() - reader.remaining();
+        Stats::record_deserialize(type_tag_v<T>, consumed, Stats::enabled && static_cast<system_type>(buffer[0]) != detect_system_type(), timer);
+        return consumed;
     }
 
     template<typename T, std::size_t N>
-    void BinaryConverter::serialize(T (&arr)[N], std::ostream &ostream) {
-        type t = find_type(arr[0]);
-        size_t size = N;
-        system_type st = detect_system_type();
-
-        ostream.write(reinterpret_cast<char *>(&st), 1); // adds the system type flag.
-        ostream.write(reinterpret_cast<const char *>(&t), 1); // adds the data type flag.
-        ostream.write(reinterpret_cast<const char *>(&size), sizeof(size_t)); // adds the size of the array.
-        for (const auto &elem: arr) {
-            serialize_element(elem, ostream); // serializes the data.
-        }
+    std::size_t BinaryConverter::deserialize(T (&arr)[N], std::span<const std::byte> buffer) {
+        return deserialize<T[N]>(arr, buffer);
     }
 
     template<typename T>
-    void BinaryConverter::serialize_element(const T &elem, std::ostream &ostream) {
-        if constexpr (std::is_same_v<T, std::string>) {
-            const std::size_t elem_size = elem.size();
-            ostream.write(reinterpret_cast<const char *>(&elem_size), sizeof(size_t));
-            ostream.write(elem.data(), elem_size);
-        } else {
-            ostream.write(reinterpret_cast<const char *>(&elem), sizeof(T));
-        }
+    T BinaryConverter::deserialize(std::span<const std::byte> buffer, std::pmr::memory_resource *resource) {
+        T obj = std::make_obj_using_allocator<T>(std::pmr::polymorphic_allocator<>(resource));
+        deserialize(obj, buffer);
+        return obj; // moving a pmr container keeps its allocator.
+    }
+
+    template<typename T>
+    T BinaryConverter::deserialize(std::istream &istream, std::pmr::memory_resource *resource) {
+        T obj = std::make_obj_using_allocator<T>(std::pmr::polymorphic_allocator<>(resource));
+        deserialize(obj, istream);
+        return obj;
     }
 }
 #endif //BINARY_DATA_PROCESSING_BINARYCONVERTER_HPP
@@ -0,0 +1,131 @@
+#ifndef BINARY_DATA_PROCESSING_BITPACKING_HPP
+#define BINARY_DATA_PROCESSING_BITPACKING_HPP
+
+/**
+ * @file BitPacking.hpp
+ * @brief Contains the BitPacker class that converts between bool arrays and 8 bools per byte.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details Used by the PACKED_BOOL_ARRAY type. Bool i is stored in bit i % 8 of byte i / 8. Packing uses movemask,
+ * unpacking broadcasts the bits and compares them against a per-byte bit mask, both with AVX2 when available.
+ * @copyright CES Public License
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "CpuFeatures.hpp"
+
+namespace CES {
+    class BitPacker {
+#ifdef CES_X86
+        /*
+         * Packs 32 bools per iteration. A bool is 0 or 1, shifting it to the sign bit lets movemask collect it.
+         * @return the number of bools processed, a multiple of 32.
+         */
+        CES_TARGET("avx2")
+        static std::size_t pack_avx2(const bool *in, std::size_t count, unsigned char *out) {
+            std::size_t i = 0;
+            for (; i + 32 <= count; i += 32) {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+                const auto bits = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_slli_epi16(v, 7)));
+                std::memcpy(out + i / 8, &bits, 4);
+            }
+            return i;
+        }
+
+        /*
+         * SSE2 is part of x86-64, this one needs no runtime check.
+         */
+        static std::size_t pack_sse2(const bool *in, std::size_t count, unsigned char *out) {
+            std::size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+                const auto bits = static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_slli_epi16(v, 7)));
+                std::memcpy(out + i / 8, &bits, 2);
+            }
+            return i;
+        }
+
+        /*
+         * Unpacks 32 bools per iteration: byte j of the output receives byte j / 8 of the bits, then keeps bit j % 8.
+         */
+        CES_TARGET("avx2")
+        static std::size_t unpack_avx2(const unsigned char *in, std::size_t count, bool *out) {
+            const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                                    2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+            const __m256i select = _mm256_set1_epi64x(static_cast<long long>(0x8040201008040201ULL));
+            const __m256i one = _mm256_set1_epi8(1);
+            std::size_t i = 0;
+            for (; i + 32 <= count; i += 32) {
+                std::uint32_t bits;
+                std::memcpy(&bits, in + i / 8, 4);
+                __m256i v = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int>(bits)), spread);
+                v = _mm256_cmpeq_epi8(_mm256_and_si256(v, select), select);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_and_si256(v, one));
+            }
+            return i;
+        }
+
+        CES_TARGET("ssse3")
+        static std::size_t unpack_ssse3(const unsigned char *in, std::size_t count, bool *out) {
+            const __m128i spread = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1);
+            const __m128i select = _mm_set1_epi64x(static_cast<long long>(0x8040201008040201ULL));
+            const __m128i one = _mm_set1_epi8(1);
+            std::size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                std::uint16_t bits;
+                std::memcpy(&bits, in + i / 8, 2);
+                __m128i v = _mm_shuffle_epi8(_mm_set1_epi16(static_cast<short>(bits)), spread);
+                v = _mm_cmpeq_epi8(_mm_and_si128(v, select), select);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_and_si128(v, one));
+            }
+            return i;
+        }
+#endif
+
+    public:
+
+        BitPacker() = delete;
+
+        /*
+         * The number of bytes count packed bools occupy.
+         */
+        static constexpr std::size_t packed_size(std::size_t count) { return (count + 7) / 8; }
+
+        /*
+         * Packs bools, 8 per byte.
+         * @param in the bools to be packed.
+         * @param count the number of bools.
+         * @param out the packed bytes, packed_size(count) of them. The unused bits of the last byte are zero.
+         */
+        static void pack(const bool *in, std::size_t count, unsigned char *out) {
+            std::size_t i = 0;
+#ifdef CES_X86
+            i = CpuFeatures::has_avx2() ? pack_avx2(in, count, out) : pack_sse2(in, count, out);
+#endif
+            for (; i < count; i += 8) { // i is a multiple of 8 here, the tail starts on a byte boundary.
+                unsigned char byte = 0;
+                for (std::size_t j = 0; j < 8 && i + j < count; ++j) byte |= static_cast<unsigned char>(in[i + j] << j);
+                out[i / 8] = byte;
+            }
+        }
+
+        /*
+         * Unpacks bools stored 8 per byte.
+         * @param in the packed bytes.
+         * @param count the number of bools.
+         * @param out the unpacked bools.
+         */
+        static void unpack(const unsigned char *in, std::size_t count, bool *out) {
+            std::size_t i = 0;
+#ifdef CES_X86
+            if (CpuFeatures::has_avx2()) i = unpack_avx2(in, count, out);
+            else if (CpuFeatures::has_ssse3()) i = unpack_ssse3(in, count, out);
+#endif
+            for (; i < count; ++i) out[i] = (in[i / 8] >> (i % 8)) & 1;
+        }
+    };
+}
+#endif //BINARY_DATA_PROCESSING_BITPACKING_HPP
@@ -0,0 +1,287 @@
+#ifndef BINARY_DATA_PROCESSING_BLOCKCODEC_HPP
+#define BINARY_DATA_PROCESSING_BLOCKCODEC_HPP
+
+/**
+ * @file BlockCodec.hpp
+ * @brief Contains the BlockCodec class, an LZ4 block compressor, and the ByteShuffler pre-filter.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details The BlockCodec writes the LZ4 block format: sequences of literals followed by a back reference of at
+ * least 4 bytes into the last 64 KiB. The compressor takes the first match a hash table offers and never searches
+ * further, which is what keeps it fast; the decompressor checks every length and offset against the input and the
+ * output, so corrupted blocks throw instead of writing out of bounds.
+ *
+ * The ByteShuffler groups byte i of every element together. The high bytes of doubles that are close to each other
+ * are equal or nearly so, after the shuffle they form runs the codec finds, interleaved with the noisy low bytes
+ * they do not.
+ * @copyright CES Public License
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+namespace CES {
+    class BlockCodec {
+        static constexpr std::size_t min_match = 4;
+        static constexpr std::size_t max_offset = 65535;
+        static constexpr int hash_bits = 14;
+
+        /*
+         * The format ends every block with at least 5 literals and starts no match in its last 12 bytes, so the
+         * decompressor can copy in 8 byte steps without checking each one.
+         */
+        static constexpr std::size_t last_literals = 5;
+        static constexpr std::size_t match_start_limit = 12;
+
+        static std::uint32_t load32(const unsigned char *p) {
+            std::uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        static std::uint64_t load64(const unsigned char *p) {
+            std::uint64_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        static std::uint32_t hash(std::uint32_t sequence) {
+            return (sequence * 2654435761u) >> (32 - hash_bits);
+        }
+
+        /*
+         * The number of equal bytes at a and b, compared 8 at a time.
+         */
+        static std::size_t common_length(const unsigned char *a, const unsigned char *b, const unsigned char *a_end) {
+            const unsigned char *start = a;
+            while (a_end - a >= 8) {
+                const std::uint64_t diff = load64(a) ^ load64(b);
+                if (diff != 0) {
+                    if constexpr (std::endian::native == std::endian::little) a += std::countr_zero(diff) / 8;
+                    else a += std::countl_zero(diff) / 8;
+                    return static_cast<std::size_t>(a - start);
+                }
+                a += 8;
+                b += 8;
+            }
+            while (a != a_end && *a == *b) {
+                ++a;
+                ++b;
+            }
+            return static_cast<std::size_t>(a - start);
+        }
+
+        /*
+         * Writes the part of a length that does not fit the 4 bits of the token: bytes of 255, then the rest.
+         */
+        static unsigned char *write_length(std::size_t length, unsigned char *out) {
+            for (; length >= 255; length -= 255) *out++ = 255;
+            *out++ = static_cast<unsigned char>(length);
+            return out;
+        }
+
+        static std::size_t read_length(const unsigned char *&in, const unsigned char *end) {
+            std::size_t length = 0;
+            unsigned char byte;
+            do {
+                if (in == end) throw std::runtime_error("Corrupted compressed block");
+                byte = *in++;
+                length += byte;
+            } while (byte == 255);
+            return length;
+        }
+
+        /*
+         * Writes a token, its literals and, unless it is the last sequence, the offset and length of its match.
+         */
+        static unsigned char *write_sequence(const unsigned char *literals, std::size_t literal_length,
+                                             std::size_t offset, std::size_t match_length, unsigned char *out) {
+            unsigned char *token = out++;
+            *token = static_cast<unsigned char>(std::min<std::size_t>(literal_length, 15) << 4);
+            if (literal_length >= 15) out = write_length(literal_length - 15, out);
+            std::memcpy(out, literals, literal_length);
+            out += literal_length;
+            if (match_length == 0) return out;
+
+            *out++ = static_cast<unsigned char>(offset); // the offset is little endian on every system.
+            *out++ = static_cast<unsigned char>(offset >> 8);
+            match_length -= min_match;
+            *token |= static_cast<unsigned char>(std::min<std::size_t>(match_length, 15));
+            if (match_length >= 15) out = write_length(match_length - 15, out);
+            return out;
+        }
+
+    public:
+
+        BlockCodec() = delete;
+
+        /*
+         * The largest compressed size of size bytes, for incompressible input.
+         */
+        static constexpr std::size_t max_compressed_size(std::size_t size) { return size + size / 255 + 16; }
+
+        /*
+         * Compresses a block.
+         * @param in the bytes to be compressed.
+         * @param size the number of bytes.
+         * @param out the compressed block, max_compressed_size(size) bytes have to fit.
+         * @return the size of the compressed block.
+         */
+        static std::size_t compress(const unsigned char *in, std::size_t size, unsigned char *out) {
+            const unsigned char *const end = in + size;
+            const unsigned char *anchor = in;
+            unsigned char *op = out;
+
+            if (size > match_start_limit) {
+                const std::unique_ptr<std::uint32_t[]> table(new std::uint32_t[std::size_t{1} << hash_bits]());
+                const unsigned char *const match_limit = end - match_start_limit;
+                const unsigned char *const match_end = end - last_literals;
+                const unsigned char *ip = in + 1;
+                table[hash(load32(in))] = 0;
+
+                while (ip < match_limit) {
+                    const std::uint32_t sequence = load32(ip);
+                    const std::uint32_t h = hash(sequence);
+                    const unsigned char *match = in + table[h];
+                    table[h] = static_cast<std::uint32_t>(ip - in);
+                    if (match >= ip || static_cast<std::size_t>(ip - match) > max_offset || load32(match) != sequence) {
+                        ip += 1 + (static_cast<std::size_t>(ip - anchor) >> 6); // moves faster through incompressible data.
+                        continue;
+                    }
+                    while (ip > anchor && match > in && ip[-1] == match[-1]) { // the match may start earlier.
+                        --ip;
+                        --match;
+                    }
+                    const std::size_t length = min_match + common_length(ip + min_match, match + min_match, match_end);
+                    op = write_sequence(anchor, static_cast<std::size_t>(ip - anchor),
+                                        static_cast<std::size_t>(ip - match), length, op);
+                    ip += length;
+                    anchor = ip;
+                    if (ip < match_limit) table[hash(load32(ip - 2))] = static_cast<std::uint32_t>(ip - 2 - in);
+                }
+            }
+            op = write_sequence(anchor, static_cast<std::size_t>(end - anchor), 0, 0, op);
+            return static_cast<std::size_t>(op - out);
+        }
+
+        /*
+         * Decompresses a block.
+         * @param in the compressed block.
+         * @param size the size of the compressed block.
+         * @param out the decompressed bytes.
+         * @param capacity the number of bytes the block decompresses to. Anything else throws.
+         */
+        static void decompress(const unsigned char *in, std::size_t size, unsigned char *out, std::size_t capacity) {
+            const unsigned char *ip = in;
+            const unsigned char *const end = in + size;
+            unsigned char *op = out;
+            unsigned char *const out_end = out + capacity;
+
+            while (true) {
+                if (ip == end) throw std::runtime_error("Corrupted compressed block");
+                const unsigned char token = *ip++;
+
+                std::size_t literal_length = token >> 4;
+                if (literal_length == 15) literal_length += read_length(ip, end);
+                if (literal_length > static_cast<std::size_t>(end - ip) || literal_length > static_cast<std::size_t>(out_end - op))
+                    throw std::runtime_error("Corrupted compressed block");
+                if (end - ip >= 16 && out_end - op >= 16 && literal_length <= 16) std::memcpy(op, ip, 16); // a fixed size copy is a single load and store.
+                else std::memcpy(op, ip, literal_length);
+                ip += literal_length;
+                op += literal_length;
+                if (ip == end) break; // the last sequence has no match.
+
+                if (end - ip < 2) throw std::runtime_error("Corrupted compressed block");
+                const std::size_t offset = ip[0] | static_cast<std::size_t>(ip[1]) << 8;
+                ip += 2;
+                std::size_t match_length = token & 15;
+                if (match_length == 15) match_length += read_length(ip, end);
+                match_length += min_match;
+                if (offset == 0 || offset > static_cast<std::size_t>(op - out) || match_length > static_cast<std::size_t>(out_end - op))
+                    throw std::runtime_error("Corrupted compressed block");
+
+                const unsigned char *match = op - offset;
+                unsigned char *const copy_end = op + match_length;
+                if (static_cast<std::size_t>(out_end - copy_end) >= 16) {
+                    if (offset < 8) { // the match overlaps the output: it repeats the last offset bytes.
+                        const std::size_t period = offset * ((8 + offset - 1) / offset); // a repetition of 8 bytes or more.
+                        for (std::size_t i = 0; i < period; ++i) op[i] = match[i];
+                        op += period;
+                        match = op - period;
+                    }
+                    while (op < copy_end) { // may write up to 10 bytes past the match, what follows overwrites them.
+                        std::memcpy(op, match, 8);
+                        op += 8;
+                        match += 8;
+                    }
+                    op = copy_end;
+                } else {
+                    while (op != copy_end) *op++ = *match++;
+                }
+            }
+            if (op != out_end) throw std::runtime_error("Corrupted compressed block");
+        }
+    };
+
+    class ByteShuffler {
+        template<std::size_t W>
+        static void shuffle_fixed(const unsigned char *in, std::size_t count, unsigned char *out) {
+            for (std::size_t i = 0; i < count; ++i)
+                for (std::size_t b = 0; b < W; ++b) out[b * count + i] = in[i * W + b];
+        }
+
+        template<std::size_t W>
+        static void unshuffle_fixed(const unsigned char *in, std::size_t count, unsigned char *out) {
+            for (std::size_t i = 0; i < count; ++i)
+                for (std::size_t b = 0; b < W; ++b) out[i * W + b] = in[b * count + i];
+        }
+
+    public:
+
+        ByteShuffler() = delete;
+
+        /*
+         * Writes byte 0 of every element, then byte 1 of every element and so on. Bytes after the last whole
+         * element are copied as they are.
+         * @param in the elements.
+         * @param size the number of bytes.
+         * @param width the size of an element.
+         * @param out the shuffled bytes, they must not overlap the input.
+         */
+        static void shuffle(const unsigned char *in, std::size_t size, std::size_t width, unsigned char *out) {
+            const std::size_t count = width == 0 ? 0 : size / width;
+            switch (width) {
+                case 2: shuffle_fixed<2>(in, count, out); break;
+                case 4: shuffle_fixed<4>(in, count, out); break;
+                case 8: shuffle_fixed<8>(in, count, out); break;
+                default:
+                    for (std::size_t i = 0; i < count; ++i)
+                        for (std::size_t b = 0; b < width; ++b) out[b * count + i] = in[i * width + b];
+            }
+            std::memcpy(out + count * width, in + count * width, size - count * width);
+        }
+
+        /*
+         * Reverses shuffle.
+         */
+        static void unshuffle(const unsigned char *in, std::size_t size, std::size_t width, unsigned char *out) {
+            const std::size_t count = width == 0 ? 0 : size / width;
+            switch (width) {
+                case 2: unshuffle_fixed<2>(in, count, out); break;
+                case 4: unshuffle_fixed<4>(in, count, out); break;
+                case 8: unshuffle_fixed<8>(in, count, out); break;
+                default:
+                    for (std::size_t i = 0; i < count; ++i)
+                        for (std::size_t b = 0; b < width; ++b) out[i * width + b] = in[b * count + i];
+            }
+            std::memcpy(out + count * width, in + count * width, size - count * width);
+        }
+    };
+}
+#endif //BINARY_DATA_PROCESSING_BLOCKCODEC_HPP
@@ -0,0 +1,125 @@
+#ifndef BINARY_DATA_PROCESSING_BYTEBUFFER_HPP
+#define BINARY_DATA_PROCESSING_BYTEBUFFER_HPP
+
+/**
+ * @file ByteBuffer.hpp
+ * @brief Contains the ByteBuffer and ByteReader classes, the contiguous memory backend of the BinaryConverter.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details The ByteBuffer is a growable arena the serializer appends to with plain memcpy calls, the ByteReader is a
+ * bounds checked cursor over a span of bytes the deserializer reads from. Neither goes through a virtual call.
+ * @copyright CES Public License
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+
+namespace CES {
+    class ByteBuffer {
+        std::unique_ptr<std::byte[]> storage; // not value initialized, the bytes are always written before being read.
+        std::size_t used = 0;
+        std::size_t allocated = 0;
+
+    public:
+
+        ByteBuffer() = default;
+
+        /*
+         * @param capacity the number of bytes allocated up front.
+         */
+        explicit ByteBuffer(std::size_t capacity) { reserve(capacity); }
+
+        /*
+         * Makes sure that at least capacity bytes fit without another allocation. Keeps the current content.
+         */
+        void reserve(std::size_t capacity) {
+            if (capacity <= allocated) return;
+            std::unique_ptr<std::byte[]> bigger(new std::byte[capacity]);
+            if (used != 0) std::memcpy(bigger.get(), storage.get(), used);
+            storage = std::move(bigger);
+            allocated = capacity;
+        }
+
+        /*
+         * Appends count uninitialized bytes and returns a pointer to them. The caller has to fill all of them.
+         * The capacity grows geometrically, so repeated appends are amortized O(1).
+         */
+        std::byte *grow(std::size_t count) {
+            if (allocated - used < count) reserve(std::max(used + count, allocated * 2));
+            std::byte *out = storage.get() + used;
+            used += count;
+            return out;
+        }
+
+        /*
+         * Appends a copy of count bytes.
+         */
+        void write(const void *bytes, std::size_t count) {
+            if (count != 0) std::memcpy(grow(count), bytes, count);
+        }
+
+        /*
+         * Forgets the content but keeps the memory, so the buffer can be reused for the next message.
+         */
+        void clear() { used = 0; }
+
+        /*
+         * Drops everything after the first size bytes.
+         */
+        void truncate(std::size_t size) { used = std::min(used, size); }
+
+        /*
+         * Drops the first count bytes and moves the rest to the front.
+         */
+        void consume(std::size_t count) {
+            count = std::min(count, used);
+            if (count != used && count != 0) std::memmove(storage.get(), storage.get() + count, used - count);
+            used -= count;
+        }
+
+        [[nodiscard]] std::byte *data() { return storage.get(); }
+        [[nodiscard]] const std::byte *data() const { return storage.get(); }
+        [[nodiscard]] std::size_t size() const { return used; }
+        [[nodiscard]] std::size_t capacity() const { return allocated; }
+        [[nodiscard]] bool empty() const { return used == 0; }
+        [[nodiscard]] std::span<const std::byte> span() const { return {storage.get(), used}; }
+    };
+
+    class ByteReader {
+        const std::byte *position;
+        const std::byte *end;
+
+    public:
+
+        /*
+         * @param bytes the bytes that are going to be read. They have to outlive the reader.
+         */
+        explicit ByteReader(std::span<const std::byte> bytes) : position(bytes.data()), end(bytes.data() + bytes.size()) {}
+
+        /*
+         * Copies the next count bytes and moves past them.
+         */
+        void read(void *destination, std::size_t count) {
+            if (count != 0) std::memcpy(destination, take(count), count);
+        }
+
+        /*
+         * Returns a pointer to the next count bytes and moves past them.
+         */
+        const std::byte *take(std::size_t count) {
+            if (static_cast<std::size_t>(end - position) < count) throw std::runtime_error("Unexpected end of buffer");
+            const std::byte *current = position;
+            position += count;
+            return current;
+        }
+
+        [[nodiscard]] std::size_t remaining() const { return static_cast<std::size_t>(end - position); }
+        [[nodiscard]] const std::byte *current() const { return position; }
+    };
+}
+#endif //BINARY_DATA_PROCESSING_BYTEBUFFER_HPP
@@ -0,0 +1,206 @@
+#ifndef BINARY_DATA_PROCESSING_BYTESWAP_HPP
+#define BINARY_DATA_PROCESSING_BYTESWAP_HPP
+
+/**
+ * @file ByteSwap.hpp
+ * @brief Contains the ByteSwapper class that reverses the byte order of single values and whole buffers.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details Used by the array paths of the BinaryConverter when the data was serialized on a system with a
+ * different endianess. Single values are swapped with the compiler bswap intrinsics, buffers are swapped in place
+ * with AVX2/SSSE3 shuffles when the CPU has them.
+ * @copyright CES Public License
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "CpuFeatures.hpp"
+#if defined(_MSC_VER)
+#include <cstdlib>
+#endif
+
+namespace CES {
+    class ByteSwapper {
+        /*
+         * Unsigned integer that has exactly W bytes, the unit the compiler bswap intrinsics work on.
+         */
+        template<std::size_t W>
+        using word = std::conditional_t<W == 2, std::uint16_t, std::conditional_t<W == 4, std::uint32_t, std::uint64_t>>;
+
+        /*
+         * Reverses the bytes of a 2, 4 or 8 byte integer. Compiles to a single bswap/rol instruction.
+         */
+        template<typename U>
+        static U swap_word(U value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+            if constexpr (sizeof(U) == 2) return _byteswap_ushort(value);
+            else if constexpr (sizeof(U) == 4) return _byteswap_ulong(value);
+            else return _byteswap_uint64(value);
+#else
+            if constexpr (sizeof(U) == 2) return __builtin_bswap16(value);
+            else if constexpr (sizeof(U) == 4) return __builtin_bswap32(value);
+            else return __builtin_bswap64(value);
+#endif
+        }
+
+        /*
+         * Reverses the W bytes starting at the pointer. The memcpy calls are the bit_cast that makes this legal
+         * for floating point values, they are folded into plain loads and stores.
+         */
+        template<std::size_t W>
+        static void swap_bytes_at(unsigned char *bytes) {
+            if constexpr (W == 2 || W == 4 || W == 8) {
+                word<W> value;
+                std::memcpy(&value, bytes, W);
+                value = swap_word(value);
+                std::memcpy(bytes, &value, W);
+            } else if constexpr (W == 16) { // long double on most 64 bit systems: swap each half and exchange them.
+                std::uint64_t low, high;
+                std::memcpy(&low, bytes, 8);
+                std::memcpy(&high, bytes + 8, 8);
+                low = swap_word(low);
+                high = swap_word(high);
+                std::memcpy(bytes, &high, 8);
+                std::memcpy(bytes + 8, &low, 8);
+            } else { // odd widths such as the 12 byte long double of 32 bit x86.
+                std::reverse(bytes, bytes + W);
+            }
+        }
+
+        /*
+         * Swaps every W byte group of the buffer, one group at a time.
+         * @param bytes the start of the buffer.
+         * @param count the number of W byte values in the buffer.
+         */
+        template<std::size_t W>
+        static void swap_scalar(unsigned char *bytes, std::size_t count) {
+            for (std::size_t i = 0; i < count; ++i) {
+                swap_bytes_at<W>(bytes + i * W);
+            }
+        }
+
+#ifdef CES_X86
+        /*
+         * The pshufb control that reverses every W byte group inside a 16 byte lane.
+         */
+        template<std::size_t W>
+        static void shuffle_mask(char (&mask)[16]) {
+            for (std::size_t i = 0; i < 16; ++i) {
+                mask[i] = static_cast<char>(i - i % W + (W - 1 - i % W));
+            }
+        }
+
+        /*
+         * Swaps 16 bytes per iteration and returns the number of values processed; the tail is left to the caller.
+         */
+        template<std::size_t W>
+        CES_TARGET("ssse3")
+        static std::size_t swap_ssse3(unsigned char *bytes, std::size_t count) {
+            char m[16];
+            shuffle_mask<W>(m);
+            const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i *>(m));
+            const std::size_t total = count * W;
+            std::size_t i = 0;
+            for (; i + 16 <= total; i += 16) {
+                __m128i *p = reinterpret_cast<__m128i *>(bytes + i);
+                _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), mask));
+            }
+            return i / W;
+        }
+
+        /*
+         * Same as swap_ssse3, but 64 bytes per iteration. vpshufb works per 128 bit lane, so the mask is repeated.
+         */
+        template<std::size_t W>
+        CES_TARGET("avx2")
+        static std::size_t swap_avx2(unsigned char *bytes, std::size_t count) {
+            char m[16];
+            shuffle_mask<W>(m);
+            const __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i *>(m));
+            const __m256i mask = _mm256_broadcastsi128_si256(half);
+            const std::size_t total = count * W;
+            std::size_t i = 0;
+            for (; i + 64 <= total; i += 64) {
+                __m256i *p0 = reinterpret_cast<__m256i *>(bytes + i);
+                __m256i *p1 = reinterpret_cast<__m256i *>(bytes + i + 32);
+                const __m256i a = _mm256_loadu_si256(p0);
+                const __m256i b = _mm256_loadu_si256(p1);
+                _mm256_storeu_si256(p0, _mm256_shuffle_epi8(a, mask));
+                _mm256_storeu_si256(p1, _mm256_shuffle_epi8(b, mask));
+            }
+            for (; i + 32 <= total; i += 32) {
+                __m256i *p = reinterpret_cast<__m256i *>(bytes + i);
+                _mm256_storeu_si256(p, _mm256_shuffle_epi8(_mm256_loadu_si256(p), mask));
+            }
+            return i / W;
+        }
+#endif
+
+        /*
+         * Picks the widest kernel the CPU supports, then finishes the remaining values with the scalar loop.
+         */
+        template<std::size_t W>
+        static void swap_width(unsigned char *bytes, std::size_t count) {
+            std::size_t done = 0;
+#ifdef CES_X86
+            if constexpr (16 % W == 0) {
+                if (CpuFeatures::has_avx2()) done = swap_avx2<W>(bytes, count);
+                else if (CpuFeatures::has_ssse3()) done = swap_ssse3<W>(bytes, count);
+            }
+#endif
+            swap_scalar<W>(bytes + done * W, count - done);
+        }
+
+    public:
+
+        ByteSwapper() = delete;
+
+        /*
+         * Returns the value with its byte order reversed. The width is resolved at compile time, so integers and
+         * floating point values of 2, 4 and 8 bytes cost a single instruction.
+         * @param value the value of which the bytes are being swapped.
+         */
+        template<typename T>
+        static T swap(T value) {
+            static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be byte swapped");
+            if constexpr (sizeof(T) == 1) {
+                return value;
+            } else if constexpr (std::is_integral_v<T> && (sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)) {
+                return static_cast<T>(swap_word(static_cast<word<sizeof(T)>>(value)));
+            } else {
+                swap_bytes_at<sizeof(T)>(reinterpret_cast<unsigned char *>(&value));
+                return value;
+            }
+        }
+
+        /*
+         * Reverses the byte order of every value of a buffer in place.
+         * @param data the first value of the buffer.
+         * @param count the number of values in the buffer.
+         */
+        template<typename T>
+        static void swap_in_place(T *data, std::size_t count) {
+            if constexpr (sizeof(T) > 1) {
+                swap_width<sizeof(T)>(reinterpret_cast<unsigned char *>(data), count);
+            }
+        }
+
+        /*
+         * Copies a buffer and reverses the byte order of the copied values. Used when the source must stay intact.
+         * @param source the values to be copied.
+         * @param destination where the swapped values are written. It may not overlap with the source.
+         * @param count the number of values.
+         */
+        template<typename T>
+        static void swap_copy(const T *source, T *destination, std::size_t count) {
+            if (count == 0) return;
+            std::memcpy(destination, source, count * sizeof(T));
+            swap_in_place(destination, count);
+        }
+    };
+}
+#endif //BINARY_DATA_PROCESSING_BYTESWAP_HPP
@@ -0,0 +1,521 @@
+#ifndef BINARY_DATA_PROCESSING_CHECKSUM_HPP
+#define BINARY_DATA_PROCESSING_CHECKSUM_HPP
+
+/**
+ * @file Checksum.hpp
+ * @brief Contains CRC32C and the ChecksummedWriter and ChecksummedReader, a framed format with a checksum per block.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details The serialized values are cut into blocks and every block carries the CRC32C (Castagnoli) of its bytes,
+ * so a flipped bit or a truncated file is reported instead of being decoded into garbage. The writer computes the
+ * checksum while it copies the values into the block, in the same pass. The reader checks a block when it is first
+ * read; over memory (a buffer or a MappedReader) it can instead check every block up front, and the blocks that are
+ * skipped without being read are never checked in lazy mode.
+ *
+ * CRC32C is computed with the SSE4.2 crc32 instruction when the CPU has it, on three interleaved lanes, which hides
+ * the latency of the instruction, and combined with a table for the fixed lane length. Otherwise, and on other
+ * architectures, a slicing-by-8 table does 8 bytes per step.
+ *
+ * Layout of a frame: "CESK", the format version, the system type flag (1 byte each), the block size (4 bytes), then
+ * for every block its size and its CRC32C (4 bytes each) followed by its bytes, and a size of 0 after the last block.
+ * @copyright CES Public License
+ */
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "BinaryConverter.hpp"
+#include "CpuFeatures.hpp"
+
+#if defined(CES_X86) && (defined(__x86_64__) || defined(_M_X64))
+#define CES_CRC32C_HARDWARE 1
+#endif
+
+namespace CES {
+    class Crc32c {
+        static constexpr std::uint32_t polynomial = 0x82F63B78u; // reflected Castagnoli polynomial.
+
+        /*
+         * The bytes of a lane of the hardware kernel. The CRC of a lane is moved past the next lane with the table.
+         */
+        static constexpr std::size_t lane = 1024;
+
+        using Table = std::array<std::array<std::uint32_t, 256>, 8>;
+
+        /*
+         * Table 0 is the byte at a time table, table k the CRC of a byte followed by k zero bytes.
+         */
+        static constexpr Table slicing_tables() {
+            Table tables{};
+            for (std::uint32_t i = 0; i < 256; ++i) {
+                std::uint32_t crc = i;
+                for (int bit = 0; bit < 8; ++bit) crc = (crc >> 1) ^ (polynomial & (0 - (crc & 1)));
+                tables[0][i] = crc;
+            }
+            for (std::size_t k = 1; k < 8; ++k) {
+                for (std::size_t i = 0; i < 256; ++i) tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+            }
+            return tables;
+        }
+
+        /*
+         * a * b modulo the polynomial, both reflected.
+         */
+        static constexpr std::uint32_t multiply(std::uint32_t a, std::uint32_t b) {
+            std::uint32_t product = 0;
+            for (std::uint32_t m = 1u << 31; m != 0; m >>= 1) {
+                if (a & m) product ^= b;
+                b = (b & 1) ? (b >> 1) ^ polynomial : b >> 1;
+            }
+            return product;
+        }
+
+        /*
+         * Moving a CRC past n zero bytes is linear, so it is 4 lookups, one per byte of the CRC.
+         */
+        static constexpr std::array<std::array<std::uint32_t, 256>, 4> shift_tables(std::size_t n) {
+            std::uint32_t power = 1u << 31; // x^0.
+            for (std::size_t i = 0; i < 8 * n; ++i) power = (power & 1) ? (power >> 1) ^ polynomial : power >> 1;
+            std::array<std::array<std::uint32_t, 256>, 4> shift{};
+            for (std::size_t k = 0; k < 4; ++k) {
+                for (std::uint32_t i = 0; i < 256; ++i) shift[k][i] = multiply(power, i << (8 * k));
+            }
+            return shift;
+        }
+
+        static std::uint32_t shift_lane(std::uint32_t crc) {
+            static constexpr auto shift = shift_tables(lane);
+            return shift[0][crc & 0xFF] ^ shift[1][(crc >> 8) & 0xFF] ^ shift[2][(crc >> 16) & 0xFF] ^ shift[3][crc >> 24];
+        }
+
+        /*
+         * The CRC register over the bytes, without the inversions. Copies them to out as well when it is not null.
+         */
+        static std::uint32_t update_table(std::uint32_t crc, const unsigned char *in, std::size_t size, unsigned char *out) {
+            static constexpr Table tables = slicing_tables();
+            for (; size >= 8; size -= 8, in += 8) {
+                std::uint64_t word;
+                std::memcpy(&word, in, 8);
+                if (out) {
+                    std::memcpy(out, &word, 8);
+                    out += 8;
+                }
+                if constexpr (std::endian::native == std::endian::big) word = ByteSwapper::swap(word);
+                const auto low = static_cast<std::uint32_t>(word) ^ crc;
+                const auto high = static_cast<std::uint32_t>(word >> 32);
+                crc = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^ tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24] ^
+                      tables[3][high & 0xFF] ^ tables[2][(high >> 8) & 0xFF] ^ tables[1][(high >> 16) & 0xFF] ^ tables[0][high >> 24];
+            }
+            for (; size != 0; --size) {
+                if (out) *out++ = *in;
+                crc = (crc >> 8) ^ tables[0][(crc ^ *in++) & 0xFF];
+            }
+            return crc;
+        }
+
+#ifdef CES_CRC32C_HARDWARE
+        template<bool Copy>
+        CES_TARGET("sse4.2")
+        static std::uint32_t update_sse42(std::uint32_t crc, const unsigned char *in, std::size_t size, unsigned char *out) {
+            const auto load = [](const unsigned char *p) {
+                std::uint64_t word;
+                std::memcpy(&word, p, 8);
+                return word;
+            };
+            for (; size >= 3 * lane; size -= 3 * lane, in += 3 * lane) {
+                std::uint64_t a = crc, b = 0, c = 0;
+                for (std::size_t i = 0; i < lane; i += 8) { // three independent chains, one instruction each per cycle.
+                    const std::uint64_t x = load(in + i), y = load(in + lane + i), z = load(in + 2 * lane + i);
+                    a = _mm_crc32_u64(a, x);
+                    b = _mm_crc32_u64(b, y);
+                    c = _mm_crc32_u64(c, z);
+                    if constexpr (Copy) {
+                        std::memcpy(out + i, &x, 8);
+                        std::memcpy(out + lane + i, &y, 8);
+                        std::memcpy(out + 2 * lane + i, &z, 8);
+                    }
+                }
+                crc = shift_lane(shift_lane(static_cast<std::uint32_t>(a)) ^ static_cast<std::uint32_t>(b)) ^ static_cast<std::uint32_t>(c);
+                if constexpr (Copy) out += 3 * lane;
+            }
+            std::uint64_t wide = crc;
+            for (; size >= 8; size -= 8, in += 8) {
+                const std::uint64_t x = load(in);
+                wide = _mm_crc32_u64(wide, x);
+                if constexpr (Copy) {
+                    std::memcpy(out, &x, 8);
+                    out += 8;
+                }
+            }
+            crc = static_cast<std::uint32_t>(wide);
+            for (; size != 0; --size) {
+                if constexpr (Copy) *out++ = *in;
+                crc = _mm_crc32_u8(crc, *in++);
+            }
+            return crc;
+        }
+#endif
+
+        static std::uint32_t update(std::uint32_t crc, const void *data, std::size_t size, void *copy) {
+            const auto *in = static_cast<const unsigned char *>(data);
+            auto *out = static_cast<unsigned char *>(copy);
+#ifdef CES_CRC32C_HARDWARE
+            if (CpuFeatures::has_sse42()) return out ? update_sse42<true>(crc, in, size, out) : update_sse42<false>(crc, in, size, nullptr);
+#endif
+            return update_table(crc, in, size, out);
+        }
+
+    public:
+
+        Crc32c() = delete;
+
+        /*
+         * True when the crc32 instruction is used.
+         */
+        static bool hardware() {
+#ifdef CES_CRC32C_HARDWARE
+            return CpuFeatures::has_sse42();
+#else
+            return false;
+#endif
+        }
+
+        /*
+         * Computes the CRC32C of a range of bytes.
+         * @param crc the CRC32C of the bytes before, to continue it: compute(b, compute(a)) is the CRC of a then b.
+         */
+        static std::uint32_t compute(std::span<const std::byte> bytes, std::uint32_t crc = 0) {
+            return ~update(~crc, bytes.data(), bytes.size(), nullptr);
+        }
+
+        /*
+         * Copies bytes and computes their CRC32C in the same pass.
+         * @param destination room for source.size() bytes, not overlapping the source.
+         */
+        static std::uint32_t copy(std::byte *destination, std::span<const std::byte> source, std::uint32_t crc = 0) {
+            return ~update(~crc, source.data(), source.size(), destination);
+        }
+    };
+
+    class ChecksummedWriter {
+        std::ostream &ostream;
+        ByteBuffer block; // the block header followed by the bytes of the block.
+        ByteBuffer large; // values that are not a copy of contiguous memory are encoded here first.
+        std::size_t block_size;
+        std::uint32_t crc = 0;
+        bool finished = false;
+
+        static constexpr std::size_t block_header_size = 2 * sizeof(std::uint32_t);
+
+        /*
+         * Copies bytes into the blocks, checksumming them on the way, and writes every block that fills up.
+         */
+        void append(std::span<const std::byte> bytes) {
+            while (!bytes.empty()) {
+                const std::size_t n = std::min(bytes.size(), block_size - (block.size() - block_header_size));
+                crc = Crc32c::copy(block.grow(n), bytes.first(n), crc);
+                bytes = bytes.subspan(n);
+                if (block.size() - block_header_size == block_size) write_block();
+            }
+        }
+
+        /*
+         * Checks the block size before the block buffer is sized from it.
+         */
+        static std::size_t checked_block_size(std::size_t block_size) {
+            if (block_size == 0 || block_size > max_block_size) throw std::invalid_argument("Block size must be between 1 byte and 1 GiB");
+            return block_size;
+        }
+
+        void write_block() {
+            const std::uint32_t header[2] = {static_cast<std::uint32_t>(block.size() - block_header_size), crc};
+            if (header[0] == 0) return;
+            std::memcpy(block.data(), header, sizeof(header));
+            ostream.write(reinterpret_cast<const char *>(block.data()), static_cast<std::streamsize>(block.size()));
+            if (!ostream) throw std::runtime_error("Could not write to the checksummed stream");
+            block.clear();
+            block.grow(block_header_size);
+            crc = 0;
+        }
+
+    public:
+
+        static constexpr char magic[4] = {'C', 'E', 'S', 'K'}; // not "CESC", that starts a container.
+        static constexpr unsigned char version = 1;
+        static constexpr std::size_t default_block_size = 1 << 16;
+        static constexpr std::size_t max_block_size = 1 << 30;
+
+        /*
+         * Writes serialized values to a stream as one checksummed frame. Read it back with a ChecksummedReader.
+         * @param ostream the stream the frame is written to.
+         * @param block_size the number of bytes per checksum, at most 1 GiB.
+         */
+        explicit ChecksummedWriter(std::ostream &ostream, std::size_t block_size = default_block_size)
+                : ostream(ostream), block(block_header_size + checked_block_size(block_size)), block_size(block_size) {
+            ostream.write(magic, sizeof(magic));
+            const unsigned char flags[2] = {version, static_cast<unsigned char>(BinaryConverter::detect_system_type())};
+            ostream.write(reinterpret_cast<const char *>(flags), sizeof(flags));
+            const auto size = static_cast<std::uint32_t>(block_size);
+            ostream.write(reinterpret_cast<const char *>(&size), sizeof(size));
+            block.grow(block_header_size);
+        }
+
+        /*
+         * Ends the frame. Errors are swallowed, call finish to see them.
+         */
+        ~ChecksummedWriter() {
+            try {
+                finish();
+            } catch (...) {
+            }
+        }
+
+        ChecksummedWriter(const ChecksummedWriter &) = delete;
+        ChecksummedWriter &operator=(const ChecksummedWriter &) = delete;
+
+        /*
+         * Serializes a value into the frame. Accepts everything BinaryConverter::serialize accepts. The elements of
+         * arrays and containers are copied into the blocks straight from the object.
+         */
+        template<typename T>
+        void write(const T &obj) {
+            if (finished) throw std::logic_error("The checksummed frame is already finished");
+            if constexpr (BinaryConverter::is_contiguous<T>) {
+                std::byte header[BinaryConverter::header_size + sizeof(size_t)];
+                const size_t size = std::size(obj);
+                std::memcpy(BinaryConverter::write_header(type_tag_v<T>, header), &size, sizeof(size_t));
+                append(header);
+                append(std::as_bytes(std::span(std::data(obj), size)));
+            } else {
+                large.clear();
+                const std::size_t size = BinaryConverter::size_of(obj);
+                BinaryConverter::encode(obj, large.grow(size));
+                append(large.span());
+            }
+        }
+
+        template<typename T, std::size_t N>
+        void write(const T (&arr)[N]) { write<T[N]>(arr); }
+
+        /*
+         * Writes the last block and the end of the frame and flushes the stream. Nothing can be written after.
+         */
+        void finish() {
+            if (finished) return;
+            finished = true;
+            write_block();
+            const std::uint32_t end = 0;
+            ostream.write(reinterpret_cast<const char *>(&end), sizeof(end));
+            ostream.flush();
+            if (!ostream) throw std::runtime_error("Could not write to the checksummed stream");
+        }
+    };
+
+    class ChecksummedReader {
+        struct Block {
+            const std::byte *data;
+            std::uint32_t size;
+            std::uint32_t crc;
+        };
+
+        std::istream *istream = nullptr; // the frame comes from a stream, or
+        std::vector<Block> blocks; // from memory, every block is known up front.
+        std::vector<bool> verified;
+        std::size_t next = 0; // the block after the current one.
+        std::size_t frame_size = 0;
+        std::uint32_t block_size = 0; // the largest block the header allows.
+        ByteBuffer loaded; // the current block of a stream.
+        bool swap = false;
+        bool ended = false;
+
+        const std::byte *current = nullptr;
+        std::size_t position = 0;
+        std::size_t length = 0;
+
+        static void check(const Block &block, std::size_t index) {
+            if (Crc32c::compute({block.data, block.size}) != block.crc)
+                throw std::runtime_error("Checksum mismatch in block " + std::to_string(index));
+        }
+
+        std::uint32_t read_u32() {
+            std::uint32_t value;
+            istream->read(reinterpret_cast<char *>(&value), sizeof(value));
+            if (istream->gcount() != sizeof(value)) throw std::runtime_error("Unexpected end of checksummed stream");
+            return swap ? ByteSwapper::swap(value) : value;
+        }
+
+        /*
+         * Reads the system type flag and the version of a frame header.
+         */
+        void read_header(const unsigned char *header) {
+            if (std::memcmp(header, ChecksummedWriter::magic, sizeof(ChecksummedWriter::magic)) != 0)
+                throw std::invalid_argument("Not a checksummed frame");
+            if (header[4] != ChecksummedWriter::version)
+                throw std::invalid_argument("Unsupported checksummed frame version: " + std::to_string(header[4]));
+            swap = static_cast<system_type>(header[5]) != BinaryConverter::detect_system_type();
+        }
+
+        /*
+         * Moves to the next block, checking it unless it was checked already.
+         * @return false after the last block.
+         */
+        bool load_next() {
+            if (istream) {
+                if (ended) return false;
+                const std::uint32_t size = read_u32();
+                if (size == 0) {
+                    ended = true;
+                    return false;
+                }
+                if (size > block_size) throw std::runtime_error("Corrupted checksummed frame"); // checked before allocating.
+                const std::uint32_t crc = read_u32();
+                loaded.clear();
+                istream->read(reinterpret_cast<char *>(loaded.grow(size)), size);
+                if (static_cast<std::size_t>(istream->gcount()) != size) throw std::runtime_error("Unexpected end of checksummed stream");
+                check({loaded.data(), size, crc}, next++);
+                current = loaded.data();
+                length = size;
+            } else {
+                if (next == blocks.size()) return false;
+                if (!verified[next]) {
+                    check(blocks[next], next);
+                    verified[next] = true;
+                }
+                current = blocks[next].data;
+                length = blocks[next++].size;
+            }
+            position = 0;
+            return true;
+        }
+
+    public:
+
+        /*
+         * Opens a frame in memory. The block headers are read, the blocks are not touched unless lazy is false.
+         * @param frame the bytes of the frame, for example MappedReader::bytes(). They have to outlive the reader.
+         * @param lazy true to check a block only when a value is read from it, false to check every block now.
+         */
+        explicit ChecksummedReader(std::span<const std::byte> frame, bool lazy = false) {
+            ByteReader reader(frame);
+            unsigned char header[sizeof(ChecksummedWriter::magic) + 2];
+            reader.read(header, sizeof(header));
+            read_header(header);
+            reader.read(&block_size, sizeof(block_size));
+            if (swap) block_size = ByteSwapper::swap(block_size);
+            while (true) {
+                std::uint32_t fields[2];
+                reader.read(fields, sizeof(std::uint32_t));
+                if (swap) fields[0] = ByteSwapper::swap(fields[0]);
+                if (fields[0] == 0) break;
+                if (fields[0] > block_size) throw std::runtime_error("Corrupted checksummed frame");
+                reader.read(fields + 1, sizeof(std::uint32_t));
+                if (swap) fields[1] = ByteSwapper::swap(fields[1]);
+                blocks.push_back({reader.take(fields[0]), fields[0], fields[1]});
+            }
+            frame_size = frame.size() - reader.remaining();
+            verified.assign(blocks.size(), false);
+            if (!lazy) verify();
+        }
+
+        /*
+         * Reads a frame from a stream, block by block. Every block is checked when it is read.
+         * @param istream the stream, positioned at the frame header. It is left after the end of the frame once
+         * at_end() returned true.
+         */
+        explicit ChecksummedReader(std::istream &istream) : istream(&istream) {
+            unsigned char header[sizeof(ChecksummedWriter::magic) + 2];
+            istream.read(reinterpret_cast<char *>(header), sizeof(header));
+            if (istream.gcount() != sizeof(header)) throw std::runtime_error("Unexpected end of checksummed stream");
+            read_header(header);
+            block_size = read_u32();
+            if (block_size == 0 || block_size > ChecksummedWriter::max_block_size) throw std::runtime_error("Corrupted checksummed frame");
+        }
+
+        ChecksummedReader(const ChecksummedReader &) = delete;
+        ChecksummedReader &operator=(const ChecksummedReader &) = delete;
+
+        /*
+         * Checks every block of a frame in memory that was not checked yet.
+         */
+        void verify() {
+            for (std::size_t i = 0; i < blocks.size(); ++i) {
+                if (!verified[i]) {
+                    check(blocks[i], i);
+                    verified[i] = true;
+                }
+            }
+        }
+
+        /*
+         * The number of bytes of a frame in memory, the next frame starts there.
+         */
+        [[nodiscard]] std::size_t size() const { return frame_size; }
+
+        /*
+         * Copies the next count bytes of the values.
+         */
+        void read(void *destination, std::size_t count) {
+            auto *out = static_cast<std::byte *>(destination);
+            while (count != 0) {
+                if (position == length && !load_next()) throw std::runtime_error("Unexpected end of checksummed frame");
+                const std::size_t n = std::min(count, length - position);
+                std::memcpy(out, current + position, n);
+                out += n;
+                position += n;
+                count -= n;
+            }
+        }
+
+        /*
+         * Moves past count bytes. Over memory, the blocks that are skipped as a whole are not checked.
+         */
+        void skip(std::size_t count) {
+            while (count != 0) {
+                if (position == length) {
+                    if (!istream && next < blocks.size() && blocks[next].size <= count) {
+                        count -= blocks[next++].size;
+                        continue;
+                    }
+                    if (!load_next()) throw std::runtime_error("Unexpected end of checksummed frame");
+                }
+                const std::size_t n = std::min(count, length - position);
+                position += n;
+                count -= n;
+            }
+        }
+
+        /*
+         * True when every value was read.
+         */
+        bool at_end() { return position == length && !load_next(); }
+
+        /*
+         * Deserializes the next value. Accepts everything BinaryConverter::deserialize accepts.
+         */
+        template<typename T>
+        void read(T &obj) { BinaryConverter::read_value(obj, *this); }
+
+        /*
+         * Moves past the next value without decoding it.
+         * @return its type flag.
+         */
+        type skip_value() {
+            char header[BinaryConverter::header_size];
+            read(header, sizeof(header));
+            const auto t = static_cast<type>(header[1]);
+            BinaryConverter::skip_payload(t, static_cast<system_type>(header[0]) != BinaryConverter::detect_system_type(), *this);
+            return t;
+        }
+    };
+}
+#endif //BINARY_DATA_PROCESSING_CHECKSUM_HPP
@@ -0,0 +1,284 @@
+#ifndef BINARY_DATA_PROCESSING_COLUMNS_HPP
+#define BINARY_DATA_PROCESSING_COLUMNS_HPP
+
+/**
+ * @file Columns.hpp
+ * @brief Contains the columnar encoding of record arrays and the ColumnReader that decodes single columns of it.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details BinaryConverter::serialize(CES::columnar(records), ...) writes an array of structs with registered fields
+ * (see Reflection.hpp) as a COLUMNS value: every field becomes its own contiguous column, laid out like the payload
+ * of the matching *_ARRAY type without the length prefix, and a directory in front of the columns holds the type
+ * flag and the offset of each one. The ColumnReader parses the directory and decodes only the columns it is asked
+ * for, straight into separate arrays or containers; the bytes of the other columns are never touched.
+ *
+ * Layout of the payload: signature of the record struct (4 bytes), row count, column count, for every column its
+ * type flag (1 byte) and the offset of its first byte, the total length of the columns, then the columns. Counts,
+ * offsets and lengths are size_t values, like the length prefixes of the other types.
+ * @copyright CES Public License
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "BinaryConverter.hpp"
+
+namespace CES {
+    /*
+     * Writes an array or container of records column by column. The fields of the records have to be single values
+     * or strings.
+     */
+    template<typename Container>
+    class ColumnarRecords {
+        using Record = std::remove_cvref_t<decltype(*std::begin(std::declval<const Container &>()))>;
+        using Fields = decltype(std::declval<const Record &>().ces_fields());
+
+        template<std::size_t I>
+        using field_t = std::remove_cvref_t<std::tuple_element_t<I, Fields>>;
+
+        static constexpr std::size_t column_count = std::tuple_size_v<Fields>;
+
+        const Container &records;
+
+        template<std::size_t I>
+        std::size_t column_size() const {
+            using Field = field_t<I>;
+            static_assert(type_tag_v<Field> < INT_ARRAY, "Columns hold single values and strings");
+            if constexpr (type_tag_v<Field> == STRING) {
+                std::size_t size = 0;
+                for (const auto &record: records) size += sizeof(std::size_t) + std::get<I>(record.ces_fields()).size();
+                return size;
+            } else {
+                return std::size(records) * sizeof(Field);
+            }
+        }
+
+        /*
+         * Gathers field I of every record. Strings keep their length prefix, like the elements of a STRING_ARRAY.
+         */
+        template<std::size_t I>
+        std::byte *encode_column(std::byte *out) const {
+            for (const auto &record: records) {
+                const auto &field = std::get<I>(record.ces_fields());
+                if constexpr (type_tag_v<field_t<I>> == STRING) {
+                    const std::size_t length = field.size();
+                    std::memcpy(out, &length, sizeof(std::size_t));
+                    if (length != 0) std::memcpy(out + sizeof(std::size_t), field.data(), length);
+                    out += sizeof(std::size_t) + length;
+                } else {
+                    std::memcpy(out, &field, sizeof(field));
+                    out += sizeof(field);
+                }
+            }
+            return out;
+        }
+
+        static std::byte *write_size(std::size_t size, std::byte *out) {
+            std::memcpy(out, &size, sizeof(std::size_t));
+            return out + sizeof(std::size_t);
+        }
+
+    public:
+
+        /*
+         * The bytes in front of the columns: signature, row count, column count, directory and total length.
+         */
+        static constexpr std::size_t header_size = sizeof(std::uint32_t) + 3 * sizeof(std::size_t) +
+                                                   column_count * (1 + sizeof(std::size_t));
+
+        explicit ColumnarRecords(const Container &records) : records(records) {}
+
+        [[nodiscard]] std::size_t payload_size() const {
+            return [this]<std::size_t... I>(std::index_sequence<I...>) {
+                return header_size + (column_size<I>() + ... + 0);
+            }(std::make_index_sequence<column_count>{});
+        }
+
+        std::byte *encode_payload(std::byte *out) const {
+            const std::uint32_t signature = Reflection::signature<Record>();
+            std::memcpy(out, &signature, sizeof(signature));
+            out = write_size(std::size(records), out + sizeof(signature));
+            out = write_size(column_count, out);
+
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                std::size_t offset = 0;
+                ((*out++ = static_cast<std::byte>(array_type_tag<field_t<I>>::value),
+                  out = write_size(offset, out),
+                  offset += column_size<I>()), ...);
+                out = write_size(offset, out); // the total length of the columns.
+                ((out = encode_column<I>(out)), ...);
+            }(std::make_index_sequence<column_count>{});
+            return out;
+        }
+    };
+
+    template<typename Container>
+    ColumnarRecords<Container> columnar(const Container &records) { return ColumnarRecords<Container>(records); }
+
+    class ColumnReader {
+        struct Column {
+            type t;
+            std::size_t offset;
+        };
+
+        std::span<const std::byte> columns_data;
+        std::vector<Column> directory;
+        std::size_t row_count = 0;
+        std::uint32_t signature = 0;
+        std::size_t consumed = 0;
+        bool swap = false;
+
+        std::size_t read_size(ByteReader &reader) const {
+            std::size_t size;
+            reader.read(&size, sizeof(size));
+            return swap ? ByteSwapper::swap(size) : size;
+        }
+
+        /*
+         * The bytes of column i.
+         */
+        [[nodiscard]] std::span<const std::byte> column_bytes(std::size_t i) const {
+            const std::size_t end = i + 1 < directory.size() ? directory[i + 1].offset : columns_data.size();
+            return columns_data.subspan(directory[i].offset, end - directory[i].offset);
+        }
+
+        /*
+         * Decodes column I into field I of every record.
+         */
+        template<std::size_t I, typename Record>
+        void read_field(std::vector<Record> &records) const {
+            ByteReader reader(column_bytes(I));
+            for (Record &record: records) {
+                auto &field = std::get<I>(record.ces_fields());
+                BinaryConverter::read_payload(field, type_tag_v<std::remove_cvref_t<decltype(field)>>, swap, reader);
+            }
+        }
+
+        template<typename Record>
+        void check_record() const {
+            if (signature != Reflection::signature<Record>())
+                throw std::invalid_argument("Record fields do not match the fields of the serialized records");
+        }
+
+        /*
+         * The directory has to hold a column of the matching type for every field of the record, the signature alone
+         * does not vouch for the directory.
+         */
+        template<typename Record>
+        void check_columns() const {
+            using Fields = decltype(std::declval<Record &>().ces_fields());
+            if (directory.size() != std::tuple_size_v<Fields>) throw std::runtime_error("Corrupted column directory");
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                if (((directory[I].t != array_type_tag<std::remove_cvref_t<std::tuple_element_t<I, Fields>>>::value) || ...))
+                    throw std::invalid_argument("Record fields do not match the fields of the serialized records");
+            }(std::make_index_sequence<std::tuple_size_v<Fields>>{});
+        }
+
+    public:
+
+        /*
+         * Parses the header and the directory of a COLUMNS value. No column is decoded yet.
+         * @param bytes the serialized value, starting with its system and type flags. It has to outlive the reader.
+         */
+        explicit ColumnReader(std::span<const std::byte> bytes) {
+            ByteReader reader(bytes);
+            unsigned char header[2];
+            reader.read(header, sizeof(header));
+            if (static_cast<type>(header[1]) != COLUMNS)
+                throw std::invalid_argument(std::string("Object type does not match serialized data type (") + type_name(COLUMNS) + ")");
+            swap = static_cast<system_type>(header[0]) != BinaryConverter::detect_system_type();
+
+            reader.read(&signature, sizeof(signature));
+            if (swap) signature = ByteSwapper::swap(signature);
+            row_count = read_size(reader);
+            const std::size_t count = read_size(reader);
+            if (count > reader.remaining() / (1 + sizeof(std::size_t))) throw std::runtime_error("Unexpected end of buffer");
+            directory.reserve(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                unsigned char t;
+                reader.read(&t, 1);
+                directory.push_back({static_cast<type>(t), read_size(reader)});
+            }
+            const std::size_t total = read_size(reader);
+            columns_data = std::span<const std::byte>(reader.take(total), total);
+            consumed = bytes.size() - reader.remaining();
+
+            // without a column nothing holds the rows, so the count cannot be checked against the bytes.
+            if (count == 0 && row_count != 0) throw std::runtime_error("Corrupted column directory");
+            for (std::size_t i = 0; i < count; ++i) {
+                const std::size_t end = i + 1 < count ? directory[i + 1].offset : total;
+                if (directory[i].offset > end) throw std::runtime_error("Corrupted column directory");
+                // every row takes an element, or a length prefix at least in a string column.
+                const std::size_t element = directory[i].t == STRING_ARRAY ? sizeof(std::size_t) : element_size(directory[i].t);
+                if (element == 0 || (end - directory[i].offset) / element < row_count)
+                    throw std::runtime_error("Corrupted column directory");
+            }
+        }
+
+        /*
+         * The number of bytes of the COLUMNS value, the next value starts there.
+         */
+        [[nodiscard]] std::size_t size() const { return consumed; }
+
+        [[nodiscard]] std::size_t rows() const { return row_count; }
+
+        [[nodiscard]] std::size_t column_count() const { return directory.size(); }
+
+        /*
+         * The *_ARRAY type flag of column i.
+         */
+        [[nodiscard]] type column_type(std::size_t i) const { return directory.at(i).t; }
+
+        /*
+         * Decodes column i into an array or container. Only the bytes of that column are read.
+         * @param out the destination, its type flag has to match column_type(i). Containers are resized to rows().
+         */
+        template<typename T>
+        void read(std::size_t i, T &out) const {
+            if (type_tag_v<T> != column_type(i))
+                throw std::invalid_argument(std::string("Object type does not match serialized data type (") + type_name(type_tag_v<T>) + ")");
+            ByteReader reader(column_bytes(i));
+            BinaryConverter::prepare(out, row_count);
+            if constexpr (type_tag_v<T> == BOOL_ARRAY && !BinaryConverter::has_bool_data<T>) {
+                BinaryConverter::read_bools(out, row_count, false, reader);
+            } else {
+                BinaryConverter::read_elements(out, row_count, swap, reader);
+            }
+        }
+
+        /*
+         * Decodes the column of a field, e.g. read(&Tick::price, prices).
+         */
+        template<typename Record, typename Field, typename T>
+        void read(Field Record::*member, T &out) const {
+            check_record<Record>();
+            read(Reflection::field_index(member), out);
+        }
+
+        /*
+         * Decodes every column back into records.
+         */
+        template<typename Record>
+        void read_records(std::vector<Record> &records) const {
+            check_record<Record>();
+            check_columns<Record>();
+            records.resize(row_count);
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                ((read_field<I>(records)), ...);
+            }(std::make_index_sequence<std::tuple_size_v<decltype(std::declval<Record &>().ces_fields())>>{});
+        }
+    };
+}
+
+template<typename Container>
+struct type_tag<CES::ColumnarRecords<Container>> { static constexpr type value = COLUMNS; };
+
+#endif //BINARY_DATA_PROCESSING_COLUMNS_HPP
@@ -0,0 +1,352 @@
+#ifndef BINARY_DATA_PROCESSING_COMPRESSION_HPP
+#define BINARY_DATA_PROCESSING_COMPRESSION_HPP
+
+/**
+ * @file Compression.hpp
+ * @brief Contains the Compressor and the CompressedWriter, a framed block compression stage for serialized data.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details The serialized bytes are cut into blocks of a fixed size and every block is compressed on its own with the
+ * BlockCodec (see BlockCodec.hpp). A block that does not get smaller is stored as it is. Because the blocks do not
+ * depend on each other, they are compressed and decompressed on the threads of a ThreadPool.
+ *
+ * Layout of a frame: "CESZ", the format version, the system type flag, the shuffle width (1 byte each), the block
+ * size (4 bytes), then for every block its decompressed size and its stored size (4 bytes each, the high bit of the
+ * stored size marks an uncompressed block) followed by its bytes, and a decompressed size of 0 after the last block.
+ *
+ * With a shuffle width of 8 the bytes of each block are shuffled as 8 byte elements before they are compressed,
+ * which helps DOUBLE_ARRAY and LONG_ARRAY payloads a lot and other data not at all. The elements do not have to
+ * start at a multiple of 8, the bytes of equal significance still end up next to each other.
+ * @copyright CES Public License
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "BinaryConverter.hpp"
+#include "BlockCodec.hpp"
+#include "ThreadPool.hpp"
+
+namespace CES {
+    class Compressor {
+        /*
+         * Where a block sits in the frame and where it goes in the output.
+         */
+        struct Block {
+            const unsigned char *data;
+            std::uint32_t stored;
+            std::uint32_t size;
+            std::size_t offset;
+            bool compressed;
+        };
+
+        static constexpr std::uint32_t uncompressed_flag = 0x80000000u;
+
+        static std::uint32_t read_u32(ByteReader &reader, bool swap) {
+            std::uint32_t value;
+            reader.read(&value, sizeof(value));
+            return swap ? ByteSwapper::swap(value) : value;
+        }
+
+        /*
+         * Decompresses blocks [first, last) one after the other.
+         */
+        static void decompress_blocks(const Block *first, const Block *last, std::size_t block_size, std::size_t width,
+                                      std::byte *out) {
+            // the shuffled bytes are decompressed here first, once per range of blocks.
+            const std::unique_ptr<unsigned char[]> scratch(width > 1 ? new unsigned char[block_size] : nullptr);
+            for (; first != last; ++first) {
+                auto *destination = reinterpret_cast<unsigned char *>(out + first->offset);
+                if (!first->compressed) {
+                    std::memcpy(destination, first->data, first->size);
+                } else if (width > 1) {
+                    BlockCodec::decompress(first->data, first->stored, scratch.get(), first->size);
+                    ByteShuffler::unshuffle(scratch.get(), first->size, width, destination);
+                } else {
+                    BlockCodec::decompress(first->data, first->stored, destination, first->size);
+                }
+            }
+        }
+
+        /*
+         * Compresses a block into scratch, the shuffled bytes go to its second half.
+         * @return the compressed size, or the size of the block with uncompressed_flag when it did not get smaller.
+         */
+        static std::uint32_t compress_block(std::span<const std::byte> data, std::size_t width, unsigned char *scratch) {
+            const auto *in = reinterpret_cast<const unsigned char *>(data.data());
+            const auto size = static_cast<std::uint32_t>(data.size());
+            if (width > 1) {
+                ByteShuffler::shuffle(in, size, width, scratch + BlockCodec::max_compressed_size(size));
+                in = scratch + BlockCodec::max_compressed_size(size);
+            }
+            const auto compressed = static_cast<std::uint32_t>(BlockCodec::compress(in, size, scratch));
+            return compressed < size ? compressed : size | uncompressed_flag;
+        }
+
+        /*
+         * Appends the header and the bytes of a block that went through compress_block.
+         */
+        static void append_block(std::span<const std::byte> data, std::uint32_t stored, const unsigned char *scratch,
+                                 ByteBuffer &out) {
+            const std::uint32_t header[2] = {static_cast<std::uint32_t>(data.size()), stored};
+            out.write(header, sizeof(header));
+            if (stored & uncompressed_flag) out.write(data.data(), data.size());
+            else out.write(scratch, stored);
+        }
+
+    public:
+
+        Compressor() = delete;
+
+        static constexpr char magic[4] = {'C', 'E', 'S', 'Z'};
+        static constexpr unsigned char version = 1;
+        static constexpr std::size_t frame_header_size = sizeof(magic) + 3 + sizeof(std::uint32_t);
+        static constexpr std::size_t block_header_size = 2 * sizeof(std::uint32_t);
+        static constexpr std::size_t default_block_size = 1 << 18;
+
+        /*
+         * Appends the frame header.
+         * @param width the shuffle width, 1 for none.
+         * @param block_size the number of bytes per block, at most 1 GiB.
+         */
+        static void write_frame_header(ByteBuffer &out, std::size_t width, std::size_t block_size) {
+            if (width == 0 || width > 255) throw std::invalid_argument("Shuffle width must be between 1 and 255");
+            if (block_size == 0 || block_size > (std::size_t{1} << 30)) throw std::invalid_argument("Block size must be between 1 byte and 1 GiB");
+            out.write(magic, sizeof(magic));
+            const unsigned char flags[3] = {version, static_cast<unsigned char>(BinaryConverter::detect_system_type()),
+                                            static_cast<unsigned char>(width)};
+            out.write(flags, sizeof(flags));
+            const auto size = static_cast<std::uint32_t>(block_size);
+            out.write(&size, sizeof(size));
+        }
+
+        /*
+         * Appends one compressed block, or the block itself when compressing does not make it smaller.
+         * @param scratch at least 2 * max_compressed_size(data.size()) bytes.
+         */
+        static void write_block(std::span<const std::byte> data, std::size_t width, ByteBuffer &out, unsigned char *scratch) {
+            append_block(data, compress_block(data, width, scratch), scratch, out);
+        }
+
+        /*
+         * Appends the mark that ends a frame.
+         */
+        static void write_frame_end(ByteBuffer &out) {
+            const std::uint32_t end = 0;
+            out.write(&end, sizeof(end));
+        }
+
+        /*
+         * Compresses serialized data into one frame.
+         * @param data the bytes to be compressed, for example the content of a ByteBuffer.
+         * @param out the buffer the frame is appended to.
+         * @param width the shuffle width: 8 for doubles and longs, 4 for floats and ints, 1 for none.
+         * @param block_size the number of bytes per block.
+         */
+        static void compress(std::span<const std::byte> data, ByteBuffer &out, std::size_t width = 1,
+                             std::size_t block_size = default_block_size) {
+            write_frame_header(out, width, block_size);
+            const std::size_t chunk = std::min(block_size, data.size());
+            const std::unique_ptr<unsigned char[]> scratch(new unsigned char[2 * BlockCodec::max_compressed_size(chunk)]);
+            for (std::size_t i = 0; i < data.size(); i += block_size)
+                write_block(data.subspan(i, std::min(block_size, data.size() - i)), width, out, scratch.get());
+            write_frame_end(out);
+        }
+
+        /*
+         * Compresses serialized data into one frame on the threads of a pool. The frame is the same as the one
+         * of the single threaded compress, the blocks are compressed in batches and appended in order.
+         */
+        static void compress(std::span<const std::byte> data, ByteBuffer &out, ThreadPool &pool, std::size_t width = 1,
+                             std::size_t block_size = default_block_size) {
+            write_frame_header(out, width, block_size);
+            const std::size_t blocks = (data.size() + block_size - 1) / block_size;
+            const std::size_t batch = std::min(blocks, 2 * pool.size());
+            const std::size_t slot = 2 * BlockCodec::max_compressed_size(std::min(block_size, data.size()));
+            const std::unique_ptr<unsigned char[]> scratch(new unsigned char[batch * slot]);
+            std::vector<std::uint32_t> stored(batch);
+            for (std::size_t first = 0; first < blocks; first += batch) {
+                const std::size_t count = std::min(batch, blocks - first);
+                const auto block = [&](std::size_t i) {
+                    const std::size_t offset = (first + i) * block_size;
+                    return data.subspan(offset, std::min(block_size, data.size() - offset));
+                };
+                pool.run(count, [&](std::size_t i) { stored[i] = compress_block(block(i), width, scratch.get() + i * slot); });
+                for (std::size_t i = 0; i < count; ++i) append_block(block(i), stored[i], scratch.get() + i * slot, out);
+            }
+            write_frame_end(out);
+        }
+
+        /*
+         * Decompresses a frame.
+         * @param frame the bytes of the frame, starting with its header.
+         * @param out the buffer the decompressed bytes are appended to.
+         * @param pool the threads that decompress the blocks.
+         * @return the number of bytes of the frame, the next frame starts there.
+         */
+        static std::size_t decompress(std::span<const std::byte> frame, ByteBuffer &out, ThreadPool &pool) {
+            ByteReader reader(frame);
+            unsigned char header[sizeof(magic) + 3];
+            reader.read(header, sizeof(header));
+            if (std::memcmp(header, magic, sizeof(magic)) != 0) throw std::invalid_argument("Not a compressed frame");
+            if (header[4] != version)
+                throw std::invalid_argument("Unsupported compressed frame version: " + std::to_string(header[4]));
+            const bool swap = static_cast<system_type>(header[5]) != BinaryConverter::detect_system_type();
+            const std::size_t width = header[6];
+            const std::size_t block_size = read_u32(reader, swap);
+            if (width == 0 || block_size == 0 || block_size > (std::size_t{1} << 30)) throw std::runtime_error("Corrupted compressed frame");
+
+            std::vector<Block> blocks;
+            std::size_t total = 0;
+            for (std::uint32_t size; (size = read_u32(reader, swap)) != 0;) { // only the block headers are read here.
+                const std::uint32_t stored = read_u32(reader, swap);
+                const bool compressed = (stored & uncompressed_flag) == 0;
+                const std::uint32_t length = stored & ~uncompressed_flag;
+                if (size > block_size || (!compressed && length != size)) throw std::runtime_error("Corrupted compressed frame");
+                blocks.push_back({reinterpret_cast<const unsigned char *>(reader.take(length)), length, size, total, compressed});
+                total += size;
+            }
+
+            const std::size_t start = out.size();
+            std::byte *destination = out.grow(total);
+            // a few ranges of blocks per thread, so a slow block does not hold up a whole share of the frame.
+            const std::size_t tasks = std::min(blocks.size(), 4 * pool.size());
+            try {
+                pool.run(tasks, [&](std::size_t i) {
+                    decompress_blocks(blocks.data() + i * blocks.size() / tasks, blocks.data() + (i + 1) * blocks.size() / tasks,
+                                      block_size, width, destination);
+                });
+            } catch (...) {
+                out.truncate(start); // no half decompressed bytes are left behind.
+                throw;
+            }
+            return frame.size() - reader.remaining();
+        }
+
+        /*
+         * Decompresses a frame on a pool of threads started for this call.
+         * @param threads the number of threads, 0 for one per hardware thread.
+         */
+        static std::size_t decompress(std::span<const std::byte> frame, ByteBuffer &out, unsigned threads = 0) {
+            ThreadPool pool(threads);
+            return decompress(frame, out, pool);
+        }
+
+        /*
+         * Reads a frame from a stream and decompresses it.
+         * @param istream the stream, positioned at the frame header. It is left after the end of the frame.
+         */
+        static void decompress(std::istream &istream, ByteBuffer &out, unsigned threads = 0) {
+            ByteBuffer frame;
+            auto read = [&](std::size_t count) {
+                istream.read(reinterpret_cast<char *>(frame.grow(count)), static_cast<std::streamsize>(count));
+                if (static_cast<std::size_t>(istream.gcount()) != count) throw std::runtime_error("Unexpected end of compressed stream");
+            };
+            read(frame_header_size);
+            const bool swap = static_cast<system_type>(frame.data()[5]) != BinaryConverter::detect_system_type();
+            while (true) { // the frame is gathered block by block, the blocks carry their own lengths.
+                read(sizeof(std::uint32_t));
+                std::uint32_t size;
+                std::memcpy(&size, frame.data() + frame.size() - sizeof(size), sizeof(size));
+                if (size == 0) break;
+                read(sizeof(std::uint32_t));
+                std::uint32_t stored;
+                std::memcpy(&stored, frame.data() + frame.size() - sizeof(stored), sizeof(stored));
+                if (swap) stored = ByteSwapper::swap(stored);
+                const std::uint32_t length = stored & ~uncompressed_flag;
+                if (length > BlockCodec::max_compressed_size(std::size_t{1} << 30)) throw std::runtime_error("Corrupted compressed frame");
+                read(length);
+            }
+            decompress(frame.span(), out, threads);
+        }
+    };
+
+    class CompressedWriter {
+        std::ostream &ostream;
+        ByteBuffer pending;
+        ByteBuffer frame;
+        std::unique_ptr<unsigned char[]> scratch;
+        std::size_t width;
+        std::size_t block_size;
+        bool finished = false;
+
+        /*
+         * Compresses the full blocks of pending and writes them to the stream.
+         */
+        void write_blocks(bool all) {
+            std::size_t done = 0;
+            while (pending.size() - done >= block_size || (all && done != pending.size())) {
+                const std::size_t size = std::min(block_size, pending.size() - done);
+                Compressor::write_block(pending.span().subspan(done, size), width, frame, scratch.get());
+                done += size;
+            }
+            pending.consume(done);
+            if (frame.empty()) return;
+            ostream.write(reinterpret_cast<const char *>(frame.data()), static_cast<std::streamsize>(frame.size()));
+            frame.clear();
+            if (!ostream) throw std::runtime_error("Could not write to the compressed stream");
+        }
+
+    public:
+
+        /*
+         * Writes serialized values to a stream as one compressed frame. Read it back with Compressor::decompress.
+         * @param ostream the stream the frame is written to.
+         * @param width the shuffle width, see Compressor::compress.
+         * @param block_size the number of bytes per block.
+         */
+        explicit CompressedWriter(std::ostream &ostream, std::size_t width = 1,
+                                  std::size_t block_size = Compressor::default_block_size)
+                : ostream(ostream), pending(block_size), width(width), block_size(block_size) {
+            Compressor::write_frame_header(frame, width, block_size);
+            scratch.reset(new unsigned char[2 * BlockCodec::max_compressed_size(block_size)]);
+        }
+
+        /*
+         * Ends the frame. Errors are swallowed, call finish to see them.
+         */
+        ~CompressedWriter() {
+            try {
+                finish();
+            } catch (...) {
+            }
+        }
+
+        CompressedWriter(const CompressedWriter &) = delete;
+        CompressedWriter &operator=(const CompressedWriter &) = delete;
+
+        /*
+         * Serializes a value into the frame. Accepts everything BinaryConverter::serialize accepts.
+         */
+        template<typename T>
+        void write(const T &obj) {
+            if (finished) throw std::logic_error("The compressed frame is already finished");
+            BinaryConverter::serialize(obj, pending);
+            if (pending.size() >= block_size) write_blocks(false);
+        }
+
+        /*
+         * Compresses what is left, writes the end of the frame and flushes the stream. Nothing can be written after.
+         */
+        void finish() {
+            if (finished) return;
+            finished = true;
+            write_blocks(true);
+            Compressor::write_frame_end(frame);
+            ostream.write(reinterpret_cast<const char *>(frame.data()), static_cast<std::streamsize>(frame.size()));
+            frame.clear();
+            ostream.flush();
+            if (!ostream) throw std::runtime_error("Could not write to the compressed stream");
+        }
+    };
+}
+#endif //BINARY_DATA_PROCESSING_COMPRESSION_HPP
@@ -0,0 +1,253 @@
+#ifndef BINARY_DATA_PROCESSING_CONTAINER_HPP
+#define BINARY_DATA_PROCESSING_CONTAINER_HPP
+
+/**
+ * @file Container.hpp
+ * @brief Contains the ContainerWriter and ContainerReader classes, a file of named values with a trailing index.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details The values are written one after the other, exactly as BinaryConverter::serialize writes them, and the
+ * writer remembers the name, offset, type flag and length of each one. When the container is finished the index is
+ * appended, followed by a footer that holds the offset of the index. A reader loads the footer and the index only,
+ * after that any value is found with one hash lookup and read from its offset, the other values are never touched.
+ *
+ * Layout: "CESC", the format version and the system type flag (1 byte each), the values, the index (entry count,
+ * then per entry the name length, the name, the offset, the type flag (1 byte) and the length), the offset of the
+ * index and "CESI". Counts, lengths and offsets are size_t values.
+ * @copyright CES Public License
+ */
+
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "BinaryConverter.hpp"
+#include "MappedReader.hpp"
+
+namespace CES {
+    /*
+     * Where a value of a container is and what it is.
+     */
+    struct ContainerEntry {
+        std::size_t offset;
+        std::size_t length;
+        type t;
+    };
+
+    class ContainerWriter {
+        std::ostream &ostream;
+        std::vector<std::pair<std::string, ContainerEntry>> entries;
+        std::unordered_map<std::string, std::size_t> names;
+        std::size_t written;
+        bool finished = false;
+
+    public:
+
+        static constexpr char magic[4] = {'C', 'E', 'S', 'C'};
+        static constexpr char index_magic[4] = {'C', 'E', 'S', 'I'};
+        static constexpr unsigned char version = 1;
+        static constexpr std::size_t file_header_size = sizeof(magic) + 2;
+        static constexpr std::size_t footer_size = sizeof(std::size_t) + sizeof(index_magic);
+
+        /*
+         * Writes the file header. The stream does not have to be seekable, the offsets are counted.
+         * @param ostream the output stream where the container is going to be written.
+         */
+        explicit ContainerWriter(std::ostream &ostream) : ostream(ostream), written(file_header_size) {
+            ostream.write(magic, sizeof(magic));
+            const char header[2] = {static_cast<char>(version), static_cast<char>(BinaryConverter::detect_system_type())};
+            ostream.write(header, sizeof(header));
+        }
+
+        /*
+         * Writes the index if finish was not called. Errors are swallowed, call finish to see them.
+         */
+        ~ContainerWriter() {
+            try {
+                finish();
+            } catch (...) {
+            }
+        }
+
+        ContainerWriter(const ContainerWriter &) = delete;
+        ContainerWriter &operator=(const ContainerWriter &) = delete;
+
+        /*
+         * Adds a named value. Accepts everything BinaryConverter::serialize accepts.
+         * @param name the key the value is found with, unique within the container.
+         * @param obj the value that is going to be written.
+         */
+        template<typename T>
+        void add(const std::string &name, const T &obj) {
+            if (finished) throw std::logic_error("The container is already finished");
+            if (names.contains(name)) throw std::invalid_argument("Duplicate container entry: " + name);
+            const std::size_t length = BinaryConverter::size_of(obj);
+            BinaryConverter::serialize(obj, ostream);
+            if (!ostream) throw std::runtime_error("Could not write to the container");
+            names.emplace(name, entries.size());
+            entries.push_back({name, {written, length, BinaryConverter::type_of(obj)}});
+            written += length;
+        }
+
+        template<typename T, std::size_t N>
+        void add(const std::string &name, const T (&arr)[N]) { add<T[N]>(name, arr); }
+
+        /*
+         * Writes the index and the footer. Nothing can be added after.
+         */
+        void finish() {
+            if (finished) return;
+            finished = true;
+            ByteBuffer index;
+            const std::size_t count = entries.size();
+            index.write(&count, sizeof(count));
+            for (const auto &[name, entry]: entries) {
+                const std::size_t length = name.size();
+                index.write(&length, sizeof(length));
+                index.write(name.data(), length);
+                index.write(&entry.offset, sizeof(entry.offset));
+                const auto t = static_cast<unsigned char>(entry.t);
+                index.write(&t, 1);
+                index.write(&entry.length, sizeof(entry.length));
+            }
+            index.write(&written, sizeof(written));
+            index.write(index_magic, sizeof(index_magic));
+            ostream.write(reinterpret_cast<const char *>(index.data()), static_cast<std::streamsize>(index.size()));
+            ostream.flush();
+            if (!ostream) throw std::runtime_error("Could not write to the container");
+        }
+    };
+
+    class ContainerReader {
+        std::optional<MappedReader> file;
+        std::span<const std::byte> data;
+        std::unordered_map<std::string, ContainerEntry> index;
+        std::vector<std::string> order;
+        bool swap = false;
+
+        std::size_t read_size(ByteReader &reader) const {
+            std::size_t size;
+            reader.read(&size, sizeof(size));
+            return swap ? ByteSwapper::swap(size) : size;
+        }
+
+        void load() {
+            ByteReader header(data);
+            char start[ContainerWriter::file_header_size];
+            header.read(start, sizeof(start));
+            if (std::memcmp(start, ContainerWriter::magic, sizeof(ContainerWriter::magic)) != 0)
+                throw std::invalid_argument("Not a container");
+            if (static_cast<unsigned char>(start[4]) != ContainerWriter::version)
+                throw std::invalid_argument("Unsupported container version: " + std::to_string(static_cast<unsigned char>(start[4])));
+            swap = static_cast<system_type>(start[5]) != BinaryConverter::detect_system_type();
+
+            if (data.size() < ContainerWriter::file_header_size + ContainerWriter::footer_size) throw std::runtime_error("Corrupted container footer");
+            ByteReader footer(data.last(ContainerWriter::footer_size));
+            const std::size_t index_offset = read_size(footer);
+            if (std::memcmp(footer.take(sizeof(ContainerWriter::index_magic)), ContainerWriter::index_magic, sizeof(ContainerWriter::index_magic)) != 0 ||
+                index_offset < ContainerWriter::file_header_size || index_offset > data.size() - ContainerWriter::footer_size)
+                throw std::runtime_error("Corrupted container footer");
+
+            ByteReader reader(data.subspan(index_offset, data.size() - ContainerWriter::footer_size - index_offset));
+            const std::size_t count = read_size(reader);
+            if (count > reader.remaining() / (3 * sizeof(std::size_t) + 1)) throw std::runtime_error("Corrupted container index");
+            index.reserve(count);
+            order.reserve(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                const std::size_t length = read_size(reader);
+                std::string name(reinterpret_cast<const char *>(reader.take(length)), length);
+                ContainerEntry entry{};
+                entry.offset = read_size(reader);
+                unsigned char t;
+                reader.read(&t, 1);
+                entry.t = static_cast<type>(t);
+                entry.length = read_size(reader);
+                if (entry.offset > index_offset || entry.length > index_offset - entry.offset)
+                    throw std::runtime_error("Corrupted container index");
+                if (!index.emplace(name, entry).second) throw std::runtime_error("Corrupted container index");
+                order.push_back(std::move(name));
+            }
+        }
+
+    public:
+
+        /*
+         * Opens a container held in memory. Only the index is read.
+         * @param bytes the whole container. It has to outlive the reader.
+         */
+        explicit ContainerReader(std::span<const std::byte> bytes) : data(bytes) { load(); }
+
+        /*
+         * Maps a container file. Only the pages of the index are read until a value is asked for.
+         * @param path the path of the file.
+         */
+        explicit ContainerReader(const std::string &path) : file(std::in_place, path) {
+            data = file->bytes();
+            load();
+        }
+
+        ContainerReader(const ContainerReader &) = delete;
+        ContainerReader &operator=(const ContainerReader &) = delete;
+
+        [[nodiscard]] std::size_t size() const { return order.size(); }
+
+        [[nodiscard]] bool contains(const std::string &name) const { return index.contains(name); }
+
+        /*
+         * The names of the values, in the order they were added.
+         */
+        [[nodiscard]] const std::vector<std::string> &names() const { return order; }
+
+        /*
+         * The offset, length and type flag of a value. Throws std::out_of_range for an unknown name.
+         */
+        [[nodiscard]] const ContainerEntry &entry(const std::string &name) const {
+            const auto found = index.find(name);
+            if (found == index.end()) throw std::out_of_range("No container entry named " + name);
+            return found->second;
+        }
+
+        /*
+         * The serialized bytes of a value, header included, for example to pass them on without decoding them.
+         */
+        [[nodiscard]] std::span<const std::byte> bytes(const std::string &name) const {
+            const ContainerEntry &found = entry(name);
+            return data.subspan(found.offset, found.length);
+        }
+
+        /*
+         * Deserializes a value. Accepts everything BinaryConverter::deserialize accepts.
+         * @param name the name the value was added with.
+         * @param obj the object to be deserialized, its type has to match the stored type flag.
+         */
+        template<typename T>
+        void read(const std::string &name, T &obj) const { BinaryConverter::deserialize(obj, bytes(name)); }
+
+        template<typename T, std::size_t N>
+        void read(const std::string &name, T (&arr)[N]) const { BinaryConverter::deserialize(arr, bytes(name)); }
+
+        /*
+         * A view of an array value that decodes elements when they are asked for.
+         */
+        template<typename T>
+        LazyArray<T> lazy(const std::string &name) const { return LazyArray<T>::from(bytes(name)); }
+
+        /*
+         * Deserializes a value as a value of type T.
+         */
+        template<typename T>
+        T get(const std::string &name) const {
+            T obj{};
+            read(name, obj);
+            return obj;
+        }
+    };
+}
+#endif //BINARY_DATA_PROCESSING_CONTAINER_HPP
@@ -0,0 +1,95 @@
+#ifndef BINARY_DATA_PROCESSING_CPUFEATURES_HPP
+#define BINARY_DATA_PROCESSING_CPUFEATURES_HPP
+
+/**
+ * @file CpuFeatures.hpp
+ * @brief Runtime detection of the SIMD extensions used by the bulk kernels.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details The kernels are compiled with per-function target attributes, so the library does not need
+ * to be built with -mavx2 and still falls back to scalar code on older CPUs.
+ * @copyright CES Public License
+ */
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CES_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CES_TARGET(features) __attribute__((target(features)))
+#else
+#define CES_TARGET(features)
+#endif
+
+namespace CES {
+    class CpuFeatures {
+#if defined(CES_X86) && defined(_MSC_VER)
+        /*
+         * Reads one bit of a cpuid register.
+         * @param leaf the cpuid leaf.
+         * @param reg the register index (0 = eax, 1 = ebx, 2 = ecx, 3 = edx).
+         * @param bit the bit that is being tested.
+         */
+        static bool cpuid_bit(int leaf, int reg, int bit) {
+            int regs[4];
+            __cpuidex(regs, leaf, 0);
+            return (regs[reg] >> bit) & 1;
+        }
+#endif
+
+    public:
+
+        CpuFeatures() = delete;
+
+        /*
+         * SSSE3 provides pshufb, which the 128 bit byte-swap kernels are built on.
+         */
+        static bool has_ssse3() {
+#if defined(CES_X86) && (defined(__GNUC__) || defined(__clang__))
+            static const bool supported = __builtin_cpu_supports("ssse3");
+            return supported;
+#elif defined(CES_X86) && defined(_MSC_VER)
+            static const bool supported = cpuid_bit(1, 2, 9);
+            return supported;
+#else
+            return false;
+#endif
+        }
+
+        /*
+         * SSE4.2 provides the crc32 instruction, which computes CRC32C 8 bytes at a time.
+         */
+        static bool has_sse42() {
+#if defined(CES_X86) && (defined(__GNUC__) || defined(__clang__))
+            static const bool supported = __builtin_cpu_supports("sse4.2");
+            return supported;
+#elif defined(CES_X86) && defined(_MSC_VER)
+            static const bool supported = cpuid_bit(1, 2, 20);
+            return supported;
+#else
+            return false;
+#endif
+        }
+
+        /*
+         * AVX2 doubles the width of the shuffle kernels. The OS has to save the ymm registers as well.
+         */
+        static bool has_avx2() {
+#if defined(CES_X86) && (defined(__GNUC__) || defined(__clang__))
+            static const bool supported = __builtin_cpu_supports("avx2");
+            return supported;
+#elif defined(CES_X86) && defined(_MSC_VER)
+            static const bool supported = cpuid_bit(1, 2, 27) && (_xgetbv(0) & 0x6) == 0x6 && cpuid_bit(7, 1, 5);
+            return supported;
+#else
+            return false;
+#endif
+        }
+    };
+}
+#endif //BINARY_DATA_PROCESSING_CPUFEATURES_HPP
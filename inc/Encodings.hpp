@@ -0,0 +1,238 @@
+#ifndef BINARY_DATA_PROCESSING_ENCODINGS_HPP
+#define BINARY_DATA_PROCESSING_ENCODINGS_HPP
+
+/**
+ * @file Encodings.hpp
+ * @brief Wrappers that make the BinaryConverter write a value with an alternative, more compact encoding.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details A wrapper only holds a reference to the value and has its own type flag, e.g.
+ * BinaryConverter::serialize(CES::packed(flags), ostream) writes a PACKED_BOOL_ARRAY and
+ * BinaryConverter::serialize(CES::varint(counters), ostream) a VARINT_ARRAY. Reading does not need the
+ * wrapper: deserializing into the plain container accepts both the plain and the alternative type flag, so files
+ * written before the alternative encoding existed still decode.
+ * @copyright CES Public License
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "SeriesCoder.hpp"
+#include "TypeDefinitions.hpp"
+
+namespace CES {
+    /*
+     * Writes a bool array, std::array<bool, N> or std::vector<bool> with 8 bools per byte.
+     */
+    template<typename Container>
+    struct PackedBools {
+        const Container &values;
+
+        [[nodiscard]] std::size_t size() const { return std::size(values); }
+    };
+
+    template<typename Container>
+    PackedBools<Container> packed(const Container &values) { return {values}; }
+
+    /*
+     * Writes an integer, or an array or container of integers, as varints (see Varint.hpp). Signed integers are
+     * zigzag mapped. Small values take a byte or two instead of sizeof(T), and so does the array length.
+     */
+    template<typename T>
+    struct Varints {
+        const T &value;
+    };
+
+    template<typename T>
+    Varints<T> varint(const T &value) { return {value}; }
+
+    /*
+     * The payload of the time series encodings: the count, the type flag of the plain array (so that it is read
+     * back into the same element type), the byte length of the encoded series and the series (see SeriesCoder.hpp).
+     */
+    template<typename Container, typename Encode>
+    std::byte *encode_series(const Container &values, std::size_t bytes, Encode &&encode, std::byte *out) {
+        const std::size_t size = std::size(values);
+        std::memcpy(out, &size, sizeof(std::size_t));
+        out[sizeof(std::size_t)] = static_cast<std::byte>(type_tag_v<Container>);
+        std::memcpy(out + sizeof(std::size_t) + 1, &bytes, sizeof(std::size_t));
+        out += 2 * sizeof(std::size_t) + 1;
+        return reinterpret_cast<std::byte *>(encode(reinterpret_cast<unsigned char *>(out)));
+    }
+
+    /*
+     * Writes an array or container of integers as the differences between consecutive values (Order 1) or between
+     * consecutive differences (Order 2), bit packed per block. Counters and ids take a few bits per value, evenly
+     * spaced timestamps almost nothing with Order 2.
+     */
+    template<typename Container, unsigned Order>
+    struct Deltas {
+        const Container &values;
+
+        [[nodiscard]] std::size_t payload_size() const {
+            return 2 * sizeof(std::size_t) + 1 + SeriesCoder::delta_size(std::data(values), std::size(values), Order);
+        }
+
+        std::byte *encode_payload(std::byte *out) const {
+            const std::size_t bytes = SeriesCoder::delta_size(std::data(values), std::size(values), Order);
+            return encode_series(values, bytes, [this](unsigned char *coded) {
+                return SeriesCoder::encode_delta(std::data(values), std::size(values), Order, coded);
+            }, out);
+        }
+    };
+
+    template<typename Container>
+    Deltas<Container, 1> delta(const Container &values) { return {values}; }
+
+    template<typename Container>
+    Deltas<Container, 2> delta_of_delta(const Container &values) { return {values}; }
+
+    /*
+     * Writes an array or container of floats or doubles as the XOR of every value with the previous one, bit packed
+     * per block. Slowly changing readings share most of their bits with the value before.
+     */
+    template<typename Container>
+    struct XorFloats {
+        const Container &values;
+
+        [[nodiscard]] std::size_t payload_size() const {
+            return 2 * sizeof(std::size_t) + 1 + SeriesCoder::xor_size(std::data(values), std::size(values));
+        }
+
+        std::byte *encode_payload(std::byte *out) const {
+            const std::size_t bytes = SeriesCoder::xor_size(std::data(values), std::size(values));
+            return encode_series(values, bytes, [this](unsigned char *coded) {
+                return SeriesCoder::encode_xor(std::data(values), std::size(values), coded);
+            }, out);
+        }
+    };
+
+    template<typename Container>
+    XorFloats<Container> xor_floats(const Container &values) { return {values}; }
+
+    /*
+     * Writes an array or container of numbers as a plain array with a zone map in front: the minimum, the maximum,
+     * the number of elements and whether there is no NaN, for every block of block_size elements. ZonedArray::scan
+     * skips the blocks whose zone rules out a range (see ZoneMap.hpp). The payload is the count, the type flag of the
+     * plain array, the block size, the zones and the elements.
+     */
+    template<typename Container>
+    struct Zoned {
+        using element = std::remove_cvref_t<decltype(*std::data(std::declval<const Container &>()))>;
+
+        const Container &values;
+        std::size_t block_size;
+
+        [[nodiscard]] std::size_t block_count() const { return (std::size(values) + block_size - 1) / block_size; }
+
+        [[nodiscard]] std::size_t payload_size() const {
+            return 2 * sizeof(std::size_t) + 1 + block_count() * zone_size(type_tag_v<Container>) + std::size(values) * sizeof(element);
+        }
+
+        std::byte *encode_payload(std::byte *out) const {
+            const std::size_t size = std::size(values);
+            std::memcpy(out, &size, sizeof(std::size_t));
+            out[sizeof(std::size_t)] = static_cast<std::byte>(type_tag_v<Container>);
+            std::memcpy(out + sizeof(std::size_t) + 1, &block_size, sizeof(std::size_t));
+            out += 2 * sizeof(std::size_t) + 1;
+            const element *in = std::data(values);
+            for (std::size_t first = 0; first < size; first += block_size) {
+                const auto count = static_cast<std::uint32_t>(std::min(block_size, size - first));
+                element low = in[first], high = in[first];
+                bool nan_free = true;
+                if constexpr (std::is_floating_point_v<element>) {
+                    // the bounds are those of the numbers, a block of NaNs only keeps NaN bounds that match nothing.
+                    std::size_t i = first;
+                    while (i < first + count && in[i] != in[i]) ++i;
+                    nan_free = i == first;
+                    if (i < first + count) low = high = in[i];
+                    for (; i < first + count; ++i) {
+                        const element value = in[i];
+                        if (value != value) nan_free = false;
+                        else if (value < low) low = value;
+                        else if (value > high) high = value;
+                    }
+                } else {
+                    for (std::size_t i = first + 1; i < first + count; ++i) {
+                        low = std::min(low, in[i]);
+                        high = std::max(high, in[i]);
+                    }
+                }
+                std::memcpy(out, &low, sizeof(element));
+                std::memcpy(out + sizeof(element), &high, sizeof(element));
+                std::memcpy(out + 2 * sizeof(element), &count, sizeof(std::uint32_t));
+                out[2 * sizeof(element) + sizeof(std::uint32_t)] = static_cast<std::byte>(nan_free);
+                out += zone_size(type_tag_v<Container>);
+            }
+            if (size != 0) std::memcpy(out, in, size * sizeof(element));
+            return out + size * sizeof(element);
+        }
+    };
+
+    /*
+     * @param block_size the elements per zone. Smaller blocks skip more precisely, larger ones keep the map small.
+     */
+    template<typename Container>
+    Zoned<Container> zone_map(const Container &values, std::size_t block_size = 4096) {
+        if (block_size == 0 || block_size > std::numeric_limits<std::uint32_t>::max())
+            throw std::invalid_argument("Zone block size must be between 1 and 2^32 - 1");
+        return {values, block_size};
+    }
+}
+
+template<typename Container>
+struct type_tag<CES::PackedBools<Container>> {
+    static_assert(type_tag_v<Container> == BOOL_ARRAY, "Only bool arrays can be packed");
+    static constexpr type value = PACKED_BOOL_ARRAY;
+};
+
+/*
+ * Only short, int, long and long long, signed or not, and arrays of them have a varint encoding.
+ */
+template<typename T>
+struct type_tag<CES::Varints<T>> {
+    static constexpr type plain = type_tag_v<T>;
+    static constexpr bool is_array = plain >= INT_ARRAY;
+    static constexpr type scalar = is_array ? static_cast<type>(plain - INT_ARRAY) : plain;
+    static_assert(scalar <= UNSIGNED_LONG_LONG, "Only integers and arrays of integers have a varint encoding");
+    static constexpr bool is_signed = scalar == INT || scalar == SHORT || scalar == LONG || scalar == LONG_LONG;
+    static constexpr type value = is_array ? (is_signed ? ZIGZAG_VARINT_ARRAY : VARINT_ARRAY)
+                                           : (is_signed ? ZIGZAG_VARINT : VARINT);
+};
+
+/*
+ * Only arrays of short, int, long and long long, signed or not, have a delta encoding.
+ */
+template<typename Container, unsigned Order>
+struct type_tag<CES::Deltas<Container, Order>> {
+    static_assert(type_tag_v<Container> >= INT_ARRAY && type_tag_v<Container> <= UNSIGNED_LONG_LONG_ARRAY,
+                  "Only arrays of integers have a delta encoding");
+    static_assert(Order == 1 || Order == 2, "Deltas are of order 1 or 2");
+    static constexpr type value = Order == 1 ? DELTA_ARRAY : DELTA_OF_DELTA_ARRAY;
+};
+
+template<typename Container>
+struct type_tag<CES::XorFloats<Container>> {
+    static_assert(type_tag_v<Container> == FLOAT_ARRAY || type_tag_v<Container> == DOUBLE_ARRAY,
+                  "Only float and double arrays have a XOR encoding");
+    static constexpr type value = XOR_FLOAT_ARRAY;
+};
+
+/*
+ * Only arrays of short, int, long, long long, signed or not, float and double have a zone map.
+ */
+template<typename Container>
+struct type_tag<CES::Zoned<Container>> {
+    static_assert(type_tag_v<Container> >= INT_ARRAY && type_tag_v<Container> <= DOUBLE_ARRAY,
+                  "Only arrays of numbers have a zone map");
+    static constexpr type value = ZONED_ARRAY;
+};
+
+#endif //BINARY_DATA_PROCESSING_ENCODINGS_HPP
@@ -0,0 +1,249 @@
+#ifndef BINARY_DATA_PROCESSING_LAZYARRAY_HPP
+#define BINARY_DATA_PROCESSING_LAZYARRAY_HPP
+
+/**
+ * @file LazyArray.hpp
+ * @brief Contains the LazyArray class, a view of a serialized array that decodes elements only when they are asked for.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details Opening a LazyArray reads the header and the length prefix and remembers where the payload starts, the
+ * elements are not touched. Single elements, ranges and chunks are then copied out of the payload, and byte swapped
+ * when the array comes from a system with a different endianess. The payload is either in memory (a MappedReader,
+ * a ContainerReader or any buffer), or in a seekable input stream, where a range costs one seek and one read.
+ * @copyright CES Public License
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "BinaryConverter.hpp"
+
+namespace CES {
+    template<typename T>
+    class LazyArray {
+        static_assert(std::is_arithmetic_v<T>, "LazyArray holds arrays of numbers");
+
+        const std::byte *payload = nullptr; // in memory, or
+        std::istream *istream = nullptr; // in a stream, starting at offset.
+        std::streamoff offset = 0;
+        std::size_t count = 0;
+        bool swap = false;
+
+        /*
+         * Checks the header and reads the length prefix.
+         * @return true when the bytes have to be swapped.
+         */
+        template<typename Source>
+        static bool read_header(Source &source, std::size_t &size) {
+            char header[BinaryConverter::header_size];
+            source.read(header, sizeof(header));
+            if (static_cast<type>(header[1]) != type_tag_v<T[1]>)
+                throw std::invalid_argument(std::string("Object type does not match serialized data type (") + type_name(type_tag_v<T[1]>) + ")");
+            const bool swap = static_cast<system_type>(header[0]) != BinaryConverter::detect_system_type();
+            source.read(&size, sizeof(size));
+            if (swap) size = ByteSwapper::swap(size);
+            return swap;
+        }
+
+        void check_range(std::size_t first, std::size_t n) const {
+            if (first > count || n > count - first) throw std::out_of_range("Range is past the end of the array");
+        }
+
+    public:
+
+        /*
+         * Iterates over the array in chunks, every chunk is decoded into a buffer owned by the range.
+         */
+        class Chunks {
+            const LazyArray *array;
+            std::size_t chunk;
+            std::vector<T> buffer;
+
+        public:
+
+            class iterator {
+                Chunks *chunks;
+                std::size_t first;
+
+            public:
+                using value_type = std::span<const T>;
+                using difference_type = std::ptrdiff_t;
+
+                iterator(Chunks *chunks, std::size_t first) : chunks(chunks), first(first) {}
+
+                /*
+                 * Decodes the chunk. The span is valid until the next chunk is decoded.
+                 */
+                std::span<const T> operator*() const {
+                    const std::size_t n = std::min(chunks->chunk, chunks->array->size() - first);
+                    chunks->array->read_range(first, n, chunks->buffer.data());
+                    return {chunks->buffer.data(), n};
+                }
+
+                iterator &operator++() {
+                    first = std::min(first + chunks->chunk, chunks->array->size());
+                    return *this;
+                }
+
+                bool operator==(const iterator &other) const { return first == other.first; }
+            };
+
+            Chunks(const LazyArray &array, std::size_t chunk) : array(&array), chunk(chunk), buffer(std::min(chunk, array.size())) {
+                if (chunk == 0) throw std::invalid_argument("Chunk size must not be 0");
+            }
+
+            iterator begin() { return {this, 0}; }
+
+            iterator end() { return {this, array->size()}; }
+        };
+
+        /*
+         * Decodes one element per step.
+         */
+        class iterator {
+            const LazyArray *array = nullptr;
+            std::size_t i = 0;
+
+        public:
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            iterator(const LazyArray *array, std::size_t i) : array(array), i(i) {}
+
+            T operator*() const { return (*array)[i]; }
+
+            iterator &operator++() {
+                ++i;
+                return *this;
+            }
+
+            iterator operator++(int) {
+                iterator previous = *this;
+                ++i;
+                return previous;
+            }
+
+            bool operator==(const iterator &other) const { return i == other.i; }
+        };
+
+        LazyArray() = default;
+
+        /*
+         * Opens the array at the start of a buffer. Nothing after the header and the length prefix is read.
+         * @param bytes the serialized array, for example ContainerReader::bytes(name). It has to outlive the view.
+         * @param consumed when given, receives the size of the serialized array, the next value starts there.
+         */
+        static LazyArray from(std::span<const std::byte> bytes, std::size_t *consumed = nullptr) {
+            ByteReader reader(bytes);
+            LazyArray array;
+            array.swap = read_header(reader, array.count);
+            if (array.count > reader.remaining() / sizeof(T)) throw std::runtime_error("Unexpected end of buffer");
+            array.payload = reader.current();
+            if (consumed) *consumed = bytes.size() - reader.remaining() + array.count * sizeof(T);
+            return array;
+        }
+
+        /*
+         * Opens the array at the position of a seekable stream and moves the stream past it without reading the
+         * elements. The stream has to outlive the view, reading elements later restores its position.
+         */
+        static LazyArray from(std::istream &istream) {
+            BinaryConverter::StreamSource source{istream};
+            LazyArray array;
+            array.swap = read_header(source, array.count);
+            if (!istream) throw std::runtime_error("Unexpected end of stream");
+            if (array.count > static_cast<std::size_t>(std::numeric_limits<std::streamoff>::max()) / sizeof(T))
+                throw std::runtime_error("Corrupted array length");
+            array.istream = &istream;
+            array.offset = istream.tellg();
+            if (array.offset < 0) throw std::invalid_argument("The stream is not seekable");
+            istream.seekg(static_cast<std::streamoff>(array.count * sizeof(T)), std::ios::cur);
+            if (!istream) throw std::runtime_error("Unexpected end of stream");
+            return array;
+        }
+
+        [[nodiscard]] std::size_t size() const { return count; }
+
+        [[nodiscard]] bool empty() const { return count == 0; }
+
+        /*
+         * True when the elements are byte swapped as they are decoded.
+         */
+        [[nodiscard]] bool swapped() const { return swap; }
+
+        /*
+         * Decodes a range of elements into memory owned by the caller.
+         * @param first the index of the first element.
+         * @param n the number of elements.
+         * @param out room for n elements.
+         */
+        void read_range(std::size_t first, std::size_t n, T *out) const {
+            check_range(first, n);
+            if (n == 0) return;
+            if (payload) {
+                std::memcpy(out, payload + first * sizeof(T), n * sizeof(T));
+            } else {
+                const std::streampos position = istream->tellg();
+                istream->seekg(offset + static_cast<std::streamoff>(first * sizeof(T)));
+                istream->read(reinterpret_cast<char *>(out), static_cast<std::streamsize>(n * sizeof(T)));
+                const bool ok = static_cast<bool>(*istream);
+                istream->clear();
+                istream->seekg(position);
+                if (!ok) throw std::runtime_error("Unexpected end of stream");
+            }
+            if (swap) ByteSwapper::swap_in_place(out, n);
+        }
+
+        /*
+         * Decodes a range of elements.
+         */
+        std::vector<T> read_range(std::size_t first, std::size_t n) const {
+            check_range(first, n);
+            std::vector<T> elements(n);
+            read_range(first, n, elements.data());
+            return elements;
+        }
+
+        /*
+         * Decodes one element, without a bounds check.
+         */
+        T operator[](std::size_t i) const {
+            T value;
+            if (payload) {
+                std::memcpy(&value, payload + i * sizeof(T), sizeof(T));
+                return swap ? ByteSwapper::swap(value) : value;
+            }
+            read_range(i, 1, &value);
+            return value;
+        }
+
+        /*
+         * Decodes one element. Throws std::out_of_range for an index past the end.
+         */
+        T at(std::size_t i) const {
+            check_range(i, 1);
+            return (*this)[i];
+        }
+
+        /*
+         * The elements in chunks of up to chunk elements: for (std::span<const T> part: array.chunks(4096)).
+         */
+        Chunks chunks(std::size_t chunk) const { return Chunks(*this, chunk); }
+
+        iterator begin() const { return {this, 0}; }
+
+        iterator end() const { return {this, count}; }
+    };
+}
+#endif //BINARY_DATA_PROCESSING_LAZYARRAY_HPP
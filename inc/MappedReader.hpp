@@ -0,0 +1,374 @@
+#ifndef BINARY_DATA_PROCESSING_MAPPEDREADER_HPP
+#define BINARY_DATA_PROCESSING_MAPPEDREADER_HPP
+
+/**
+ * @file MappedReader.hpp
+ * @brief Contains the MappedReader class that reads files written by the BinaryConverter through a memory mapping.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details Instead of copying every value through a stream buffer, the file is mapped in memory and arrays and
+ * strings are returned as views into the mapping. A copy is only made when the bytes have to be swapped. The format
+ * does not pad the payloads, so array elements are read with unaligned copies rather than through T pointers.
+ * @copyright CES Public License
+ */
+
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "BinaryConverter.hpp"
+#include "LazyArray.hpp"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CES {
+    /*
+     * The elements of an array read from a mapping. Either a view of the bytes in the mapping, or an owned copy when
+     * the elements had to be swapped. The payloads are not padded, so the elements are copied out one at a time
+     * instead of being handed out as references that may be misaligned. It has to be used while the reader is alive.
+     */
+    template<typename T>
+    class MappedArray {
+        const std::byte *elements = nullptr;
+        std::size_t count = 0;
+        std::vector<T> copy;
+
+    public:
+
+        /*
+         * Reads one element per step.
+         */
+        class iterator {
+            const MappedArray *array = nullptr;
+            std::size_t i = 0;
+
+        public:
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            iterator(const MappedArray *array, std::size_t i) : array(array), i(i) {}
+
+            T operator*() const { return (*array)[i]; }
+
+            iterator &operator++() {
+                ++i;
+                return *this;
+            }
+
+            iterator operator++(int) {
+                iterator previous = *this;
+                ++i;
+                return previous;
+            }
+
+            bool operator==(const iterator &other) const { return i == other.i; }
+        };
+
+        MappedArray(const std::byte *elements, std::size_t count) : elements(elements), count(count) {}
+
+        explicit MappedArray(std::vector<T> &&copy) : count(copy.size()), copy(std::move(copy)) {
+            elements = reinterpret_cast<const std::byte *>(this->copy.data());
+        }
+
+        MappedArray(MappedArray &&other) noexcept { *this = std::move(other); }
+
+        MappedArray &operator=(MappedArray &&other) noexcept {
+            copy = std::move(other.copy); // the elements of a copy move with it, the pointer stays valid.
+            elements = std::exchange(other.elements, nullptr);
+            count = std::exchange(other.count, 0);
+            return *this;
+        }
+
+        MappedArray(const MappedArray &) = delete;
+        MappedArray &operator=(const MappedArray &) = delete;
+
+        /*
+         * True when the elements are read straight from the mapping.
+         */
+        [[nodiscard]] bool is_view() const { return copy.empty(); }
+
+        [[nodiscard]] std::size_t size() const { return count; }
+
+        [[nodiscard]] bool empty() const { return count == 0; }
+
+        /*
+         * The bytes of the elements, in the byte order of this system.
+         */
+        [[nodiscard]] std::span<const std::byte> bytes() const { return {elements, count * sizeof(T)}; }
+
+        /*
+         * Copies a range of elements into memory owned by the caller, one copy for the whole range.
+         * @param first the index of the first element.
+         * @param n the number of elements.
+         * @param out room for n elements.
+         */
+        void read_range(std::size_t first, std::size_t n, T *out) const {
+            if (first > count || n > count - first) throw std::out_of_range("Range is past the end of the array");
+            if (n != 0) std::memcpy(out, elements + first * sizeof(T), n * sizeof(T));
+        }
+
+        /*
+         * One element, without a bounds check.
+         */
+        T operator[](std::size_t i) const {
+            T value;
+            std::memcpy(&value, elements + i * sizeof(T), sizeof(T));
+            return value;
+        }
+
+        iterator begin() const { return {this, 0}; }
+
+        iterator end() const { return {this, count}; }
+    };
+
+    class MappedReader {
+        const std::byte *base = nullptr;
+        std::size_t length = 0;
+        std::size_t position = 0;
+#ifdef _WIN32
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+#endif
+
+        /*
+         * Reads the system flag and the type flag of the next value and checks the type flag.
+         * @param expected the type the caller asked for.
+         * @return true when the value was written on a system with a different endianess.
+         */
+        bool read_header(type expected) {
+            need(2);
+            const auto sts = static_cast<system_type>(base[position]);
+            const auto t = static_cast<type>(base[position + 1]);
+            if (t != expected)
+                throw std::invalid_argument(std::string("Object type does not match serialized data type (") + type_name(expected) + ")");
+            position += 2;
+            return sts != BinaryConverter::detect_system_type();
+        }
+
+        /*
+         * Reads a size_t length prefix.
+         */
+        std::size_t read_size(bool swap) {
+            std::size_t size;
+            need(sizeof(size));
+            std::memcpy(&size, base + position, sizeof(size));
+            position += sizeof(size);
+            return swap ? ByteSwapper::swap(size) : size;
+        }
+
+        /*
+         * Throws if less than count bytes are left in the mapping.
+         */
+        void need(std::size_t count) const {
+            if (length - position < count) throw std::runtime_error("Unexpected end of mapped file");
+        }
+
+        void unmap() {
+#ifdef _WIN32
+            if (base) UnmapViewOfFile(base);
+            if (mapping) CloseHandle(mapping);
+            if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+            mapping = nullptr;
+            file = INVALID_HANDLE_VALUE;
+#else
+            if (base) munmap(const_cast<std::byte *>(base), length);
+#endif
+            base = nullptr;
+            length = 0;
+            position = 0;
+        }
+
+    public:
+
+        /*
+         * Maps a file produced by BinaryConverter::serialize in read-only mode.
+         * @param path the path of the file.
+         */
+        explicit MappedReader(const std::string &path) {
+#ifdef _WIN32
+            file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                               FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("Could not open file: " + path);
+            LARGE_INTEGER size;
+            GetFileSizeEx(file, &size);
+            length = static_cast<std::size_t>(size.QuadPart);
+            if (length == 0) return;
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping) {
+                unmap();
+                throw std::runtime_error("Could not map file: " + path);
+            }
+            base = static_cast<const std::byte *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            if (!base) {
+                unmap();
+                throw std::runtime_error("Could not map file: " + path);
+            }
+#else
+            const int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) throw std::runtime_error("Could not open file: " + path);
+            struct stat st{};
+            if (fstat(fd, &st) != 0) {
+                close(fd);
+                throw std::runtime_error("Could not stat file: " + path);
+            }
+            length = static_cast<std::size_t>(st.st_size);
+            if (length != 0) {
+                void *address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (address == MAP_FAILED) {
+                    close(fd);
+                    length = 0;
+                    throw std::runtime_error("Could not map file: " + path);
+                }
+                base = static_cast<const std::byte *>(address);
+                madvise(address, length, MADV_SEQUENTIAL);
+            }
+            close(fd); // the mapping keeps its own reference to the file.
+#endif
+        }
+
+        ~MappedReader() { unmap(); }
+
+        MappedReader(MappedReader &&other) noexcept { *this = std::move(other); }
+
+        MappedReader &operator=(MappedReader &&other) noexcept {
+            if (this != &other) {
+                unmap();
+                base = std::exchange(other.base, nullptr);
+                length = std::exchange(other.length, 0);
+                position = std::exchange(other.position, 0);
+#ifdef _WIN32
+                file = std::exchange(other.file, INVALID_HANDLE_VALUE);
+                mapping = std::exchange(other.mapping, nullptr);
+#endif
+            }
+            return *this;
+        }
+
+        MappedReader(const MappedReader &) = delete;
+        MappedReader &operator=(const MappedReader &) = delete;
+
+        /*
+         * The whole mapped file.
+         */
+        [[nodiscard]] std::span<const std::byte> bytes() const { return {base, length}; }
+
+        /*
+         * The offset of the next value in the file.
+         */
+        [[nodiscard]] std::size_t offset() const { return position; }
+
+        /*
+         * Moves to a value at a known offset, for example one remembered from offset().
+         */
+        void seek(std::size_t offset) {
+            if (offset > length) throw std::out_of_range("Offset is past the end of the mapped file");
+            position = offset;
+        }
+
+        [[nodiscard]] bool at_end() const { return position >= length; }
+
+        /*
+         * Moves past the next value without decoding it, using its type flag and length prefix.
+         */
+        void skip() { position += BinaryConverter::skip(bytes().subspan(position)); }
+
+        /*
+         * The type flag of the next value, without consuming it.
+         */
+        [[nodiscard]] type peek_type() const {
+            if (length - position < 2) throw std::runtime_error("Unexpected end of mapped file");
+            return static_cast<type>(base[position + 1]);
+        }
+
+        /*
+         * Reads a single value serialized with BinaryConverter::serialize(T &, std::ostream &).
+         */
+        template<typename T>
+        T read() {
+            static_assert(std::is_arithmetic_v<T>, "Use read_string for strings and read_array for arrays");
+            const bool swap = read_header(type_tag_v<T>);
+            T value;
+            need(sizeof(T));
+            std::memcpy(&value, base + position, sizeof(T));
+            position += sizeof(T);
+            return swap ? ByteSwapper::swap(value) : value;
+        }
+
+        /*
+         * Reads a STRING value. The view points into the mapping, no bytes are copied.
+         */
+        std::string_view read_string() {
+            const std::size_t size = read_size(read_header(STRING));
+            need(size);
+            const std::string_view view(reinterpret_cast<const char *>(base + position), size);
+            position += size;
+            return view;
+        }
+
+        /*
+         * Reads a STRING_ARRAY value as views into the mapping.
+         */
+        std::vector<std::string_view> read_string_array() {
+            const bool swap = read_header(STRING_ARRAY);
+            const std::size_t count = read_size(swap);
+            std::vector<std::string_view> strings;
+            strings.reserve(std::min(count, (length - position) / sizeof(std::size_t)));
+            for (std::size_t i = 0; i < count; ++i) {
+                const std::size_t size = read_size(swap);
+                need(size);
+                strings.emplace_back(reinterpret_cast<const char *>(base + position), size);
+                position += size;
+            }
+            return strings;
+        }
+
+        /*
+         * Reads an array serialized with BinaryConverter::serialize(T (&)[N], std::ostream &).
+         * The result is a view into the mapping, aligned or not, unless the file has the other endianess.
+         */
+        template<typename T>
+        MappedArray<T> read_array() {
+            static_assert(std::is_arithmetic_v<T>, "Use read_string_array for arrays of strings");
+            const bool swap = read_header(type_tag_v<T[1]>);
+            const std::size_t count = read_size(swap);
+            if (count > (length - position) / sizeof(T)) throw std::runtime_error("Unexpected end of mapped file");
+            const std::byte *payload = base + position;
+            position += count * sizeof(T);
+
+            if (!swap) return MappedArray<T>(payload, count);
+            std::vector<T> copy(count);
+            if (count != 0) std::memcpy(copy.data(), payload, count * sizeof(T));
+            ByteSwapper::swap_in_place(copy.data(), count);
+            return MappedArray<T>(std::move(copy));
+        }
+
+        /*
+         * Reads the header of an array and moves past it, the elements stay in the mapping until they are asked for.
+         */
+        template<typename T>
+        LazyArray<T> read_lazy() {
+            std::size_t consumed;
+            LazyArray<T> array = LazyArray<T>::from(bytes().subspan(position), &consumed);
+            position += consumed;
+            return array;
+        }
+    };
+}
+#endif //BINARY_DATA_PROCESSING_MAPPEDREADER_HPP
@@ -0,0 +1,123 @@
+#ifndef BINARY_DATA_PROCESSING_PARALLELCONVERTER_HPP
+#define BINARY_DATA_PROCESSING_PARALLELCONVERTER_HPP
+
+/**
+ * @file ParallelConverter.hpp
+ * @brief Contains the ParallelConverter class that encodes and decodes large arrays on the threads of a ThreadPool.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details The payload of an array is split into chunks of whole elements. Every chunk is copied, and byte swapped
+ * when it comes from a system with a different endianess, by one thread, while the chunk is still in its cache.
+ * The bytes are the same the BinaryConverter writes and reads, only the work is divided. Reading from the bytes of a
+ * MappedReader, each thread faults in the pages of its own chunk, so the file is read at several positions at once.
+ * Values that are not contiguous arrays go through the BinaryConverter on the calling thread.
+ * @copyright CES Public License
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include "BinaryConverter.hpp"
+#include "ThreadPool.hpp"
+
+namespace CES {
+    class ParallelConverter {
+        /*
+         * The smallest chunk. Handing out smaller ones costs more than copying them on fewer threads.
+         */
+        static constexpr std::size_t min_chunk = std::size_t{1} << 20;
+
+        /*
+         * Calls f(first, count) for chunks of the elements of an array, a few per thread.
+         */
+        template<typename F>
+        static void for_chunks(std::size_t count, std::size_t element_size, ThreadPool &pool, F &&f) {
+            const std::size_t per_chunk = std::max(min_chunk / element_size,
+                                                   (count + 4 * pool.size() - 1) / (4 * pool.size()));
+            const std::size_t chunks = (count + per_chunk - 1) / per_chunk;
+            pool.run(chunks, [&](std::size_t i) {
+                const std::size_t first = i * per_chunk;
+                f(first, std::min(per_chunk, count - first));
+            });
+        }
+
+    public:
+
+        ParallelConverter() = delete;
+
+        /*
+         * Appends a serialized object to a buffer. Contiguous arrays and containers are copied in parallel.
+         * @param obj the object to be serialized.
+         * @param buffer the buffer the bytes are appended to.
+         * @param pool the threads that copy the payload.
+         */
+        template<typename T>
+        static void serialize(const T &obj, ByteBuffer &buffer, ThreadPool &pool) {
+            if constexpr (BinaryConverter::is_contiguous<T>) {
+                using Element = BinaryConverter::element_t<T>;
+                const std::size_t size = std::size(obj);
+                std::byte *out = buffer.grow(BinaryConverter::size_of(obj));
+                out = BinaryConverter::write_header(type_tag_v<T>, out);
+                std::memcpy(out, &size, sizeof(std::size_t));
+                out += sizeof(std::size_t);
+                const auto *elements = std::data(obj);
+                for_chunks(size, sizeof(Element), pool, [&](std::size_t first, std::size_t count) {
+                    std::memcpy(out + first * sizeof(Element), elements + first, count * sizeof(Element));
+                });
+            } else {
+                BinaryConverter::serialize(obj, buffer);
+            }
+        }
+
+        template<typename T, std::size_t N>
+        static void serialize(const T (&arr)[N], ByteBuffer &buffer, ThreadPool &pool) {
+            serialize<T[N]>(arr, buffer, pool);
+        }
+
+        /*
+         * Deserializes an object from memory. Contiguous arrays and containers are copied and byte swapped in
+         * parallel.
+         * @param obj the object to be deserialized.
+         * @param buffer the bytes it reads the data from, for example MappedReader::bytes().
+         * @param pool the threads that copy the payload.
+         * @return the number of bytes consumed, the next object starts there.
+         */
+        template<typename T>
+        static std::size_t deserialize(T &obj, std::span<const std::byte> buffer, ThreadPool &pool) {
+            if constexpr (BinaryConverter::is_contiguous<T>) {
+                using Element = BinaryConverter::element_t<T>;
+                ByteReader reader(buffer);
+                unsigned char header[BinaryConverter::header_size];
+                reader.read(header, sizeof(header));
+                if (static_cast<type>(header[1]) != type_tag_v<T>) return BinaryConverter::deserialize(obj, buffer);
+                const bool swap = static_cast<system_type>(header[0]) != BinaryConverter::detect_system_type();
+
+                std::size_t size;
+                reader.read(&size, sizeof(size));
+                if (swap) size = ByteSwapper::swap(size);
+                if constexpr (type_tag_v<T> == STRING) BinaryConverter::check_string_length(size);
+                if (size > reader.remaining() / sizeof(Element)) throw std::runtime_error("Unexpected end of buffer");
+                const std::byte *payload = reader.take(size * sizeof(Element));
+                BinaryConverter::prepare(obj, size);
+
+                auto *elements = std::data(obj);
+                for_chunks(size, sizeof(Element), pool, [&](std::size_t first, std::size_t count) {
+                    std::memcpy(elements + first, payload + first * sizeof(Element), count * sizeof(Element));
+                    if (swap) ByteSwapper::swap_in_place(elements + first, count);
+                });
+                return buffer.size() - reader.remaining();
+            } else {
+                return BinaryConverter::deserialize(obj, buffer); // other types and alternative encodings.
+            }
+        }
+
+        template<typename T, std::size_t N>
+        static std::size_t deserialize(T (&arr)[N], std::span<const std::byte> buffer, ThreadPool &pool) {
+            return deserialize<T[N]>(arr, buffer, pool);
+        }
+    };
+}
+#endif //BINARY_DATA_PROCESSING_PARALLELCONVERTER_HPP
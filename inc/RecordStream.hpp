@@ -0,0 +1,243 @@
+#ifndef BINARY_DATA_PROCESSING_RECORDSTREAM_HPP
+#define BINARY_DATA_PROCESSING_RECORDSTREAM_HPP
+
+/**
+ * @file RecordStream.hpp
+ * @brief Contains the RecordWriter and RecordReader classes, a batched format for many small values.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details The system type flag is written once in a file header together with a format version, and every record
+ * only carries its 1 byte data type flag followed by the same payload the BinaryConverter writes. Records are
+ * gathered in a buffer and reach the stream in large blocks, so writing a million ints is a handful of stream calls
+ * instead of millions. The reader works the same way in reverse and hands out the records one at a time.
+ * @copyright CES Public License
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include "BinaryConverter.hpp"
+
+namespace CES {
+    class RecordWriter {
+        std::ostream &ostream;
+        ByteBuffer buffer;
+        std::size_t block_size;
+
+    public:
+
+        /*
+         * Identifies a record stream: "CESR", followed by the format version and the system type flag.
+         */
+        static constexpr char magic[4] = {'C', 'E', 'S', 'R'};
+        static constexpr unsigned char version = 1;
+        static constexpr std::size_t file_header_size = sizeof(magic) + 2;
+
+        /*
+         * Writes the file header. Nothing reaches the stream before the first block is full or flush is called.
+         * @param ostream the output stream where the records are going to be written.
+         * @param block_size the number of bytes gathered before they are written to the stream.
+         */
+        explicit RecordWriter(std::ostream &ostream, std::size_t block_size = 1 << 16)
+                : ostream(ostream), buffer(block_size), block_size(block_size) {
+            buffer.write(magic, sizeof(magic));
+            const unsigned char header[2] = {version, static_cast<unsigned char>(BinaryConverter::detect_system_type())};
+            buffer.write(header, sizeof(header));
+        }
+
+        /*
+         * Flushes the records that are still buffered. Errors are swallowed, call flush to see them.
+         */
+        ~RecordWriter() {
+            try {
+                flush();
+            } catch (...) {
+            }
+        }
+
+        RecordWriter(const RecordWriter &) = delete;
+        RecordWriter &operator=(const RecordWriter &) = delete;
+
+        /*
+         * Adds a record. Accepts everything BinaryConverter::serialize accepts.
+         * @param obj the value that is going to be written.
+         */
+        template<typename T>
+        void write(const T &obj) {
+            const std::size_t size = 1 + BinaryConverter::payload_size(obj);
+            std::byte *out = buffer.grow(size);
+            *out = static_cast<std::byte>(BinaryConverter::type_of(obj)); // a wrapper may fall back to the plain flag.
+            BinaryConverter::encode_payload(obj, out + 1);
+            if (buffer.size() >= block_size) flush();
+        }
+
+        /*
+         * Writes the buffered records to the stream with a single write.
+         */
+        void flush() {
+            if (buffer.empty()) return;
+            ostream.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+            if (!ostream) throw std::runtime_error("Could not write to the record stream");
+        }
+    };
+
+    class RecordReader {
+        /*
+         * Gives the BinaryConverter the read interface it expects from a source.
+         */
+        struct BlockSource {
+            RecordReader &reader;
+
+            void read(void *destination, std::size_t count) { reader.read_bytes(destination, count); }
+
+            void skip(std::size_t count) { reader.discard(count); }
+        };
+
+        std::istream &istream;
+        std::unique_ptr<std::byte[]> block;
+        std::size_t block_size;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+        bool swap = false;
+        type current = INT;
+        bool pending = false; // the header of the current record was read but its payload was not.
+        bool failed = false; // a payload was left half read, where the next record starts is lost.
+
+        /*
+         * Reads the next block from the stream.
+         * @return false at the end of the stream.
+         */
+        bool refill() {
+            istream.read(reinterpret_cast<char *>(block.get()), static_cast<std::streamsize>(block_size));
+            begin = 0;
+            end = static_cast<std::size_t>(istream.gcount());
+            return end != 0;
+        }
+
+        /*
+         * Copies count bytes out of the blocks. Reads larger than a block bypass it.
+         */
+        void read_bytes(void *destination, std::size_t count) {
+            auto *out = static_cast<std::byte *>(destination);
+            const std::size_t buffered = std::min(count, end - begin);
+            if (buffered != 0) std::memcpy(out, block.get() + begin, buffered);
+            begin += buffered;
+            out += buffered;
+            count -= buffered;
+            if (count == 0) return;
+
+            if (count >= block_size) {
+                istream.read(reinterpret_cast<char *>(out), static_cast<std::streamsize>(count));
+                if (static_cast<std::size_t>(istream.gcount()) != count)
+                    throw std::runtime_error("Unexpected end of record stream");
+                return;
+            }
+            refill();
+            if (end < count) throw std::runtime_error("Unexpected end of record stream");
+            std::memcpy(out, block.get(), count);
+            begin = count;
+        }
+
+        /*
+         * Moves past count bytes without copying them.
+         */
+        void discard(std::size_t count) {
+            const std::size_t buffered = std::min(count, end - begin);
+            begin += buffered;
+            count -= buffered;
+            if (count == 0) return;
+            istream.ignore(static_cast<std::streamsize>(count));
+            if (static_cast<std::size_t>(istream.gcount()) != count)
+                throw std::runtime_error("Unexpected end of record stream");
+        }
+
+    public:
+
+        /*
+         * Reads and checks the file header.
+         * @param istream the input stream where it reads the records from.
+         * @param block_size the number of bytes read from the stream at once.
+         */
+        explicit RecordReader(std::istream &istream, std::size_t block_size = 1 << 16)
+                : istream(istream), block(new std::byte[block_size]), block_size(block_size) {
+            unsigned char header[RecordWriter::file_header_size];
+            read_bytes(header, sizeof(header));
+            if (std::memcmp(header, RecordWriter::magic, sizeof(RecordWriter::magic)) != 0)
+                throw std::invalid_argument("Not a record stream");
+            if (header[4] != RecordWriter::version)
+                throw std::invalid_argument("Unsupported record stream version: " + std::to_string(header[4]));
+            swap = static_cast<system_type>(header[5]) != BinaryConverter::detect_system_type();
+        }
+
+        RecordReader(const RecordReader &) = delete;
+        RecordReader &operator=(const RecordReader &) = delete;
+
+        /*
+         * Moves to the next record. A record that was not read is skipped.
+         * @return false when there are no more records.
+         */
+        bool next() {
+            if (failed) throw std::runtime_error("Record stream cannot continue after a failed read");
+            if (pending) {
+                pending = false;
+                BlockSource source{*this};
+                try {
+                    BinaryConverter::skip_payload(current, swap, source); // jumps over the payload, using its type flag and length prefix.
+                } catch (...) {
+                    failed = true;
+                    throw;
+                }
+            }
+            if (begin == end && !refill()) return false;
+            current = static_cast<type>(block[begin++]);
+            if (!is_known_type(current)) {
+                failed = true; // without the type the payload cannot be skipped.
+                throw std::invalid_argument("Data type not accepted");
+            }
+            pending = true;
+            return true;
+        }
+
+        /*
+         * The type flag of the current record, to decide what to read it into.
+         */
+        [[nodiscard]] type current_type() const { return current; }
+
+        /*
+         * Reads the current record. Accepts everything BinaryConverter::deserialize accepts. A record of another type
+         * can still be skipped, but a payload that fails halfway leaves the stream unusable and next() throws.
+         * @param obj the object to be deserialized, its type has to match the type flag of the record.
+         */
+        template<typename T>
+        void read(T &obj) {
+            if (!pending) throw std::logic_error("No current record, call next first");
+            if (!BinaryConverter::accepts<T>(current))
+                throw std::invalid_argument(std::string("Object type does not match serialized data type (") + type_name(type_tag_v<T>) + ")");
+            BlockSource source{*this};
+            pending = false;
+            try {
+                BinaryConverter::read_payload(obj, current, swap, source);
+            } catch (...) {
+                failed = true; // the payload was read partway, the next byte is not the start of a record.
+                throw;
+            }
+        }
+
+        /*
+         * Reads the current record as a value of type T.
+         */
+        template<typename T>
+        T get() {
+            T obj{};
+            read(obj);
+            return obj;
+        }
+    };
+}
+#endif //BINARY_DATA_PROCESSING_RECORDSTREAM_HPP
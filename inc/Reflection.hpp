@@ -0,0 +1,145 @@
+#ifndef BINARY_DATA_PROCESSING_REFLECTION_HPP
+#define BINARY_DATA_PROCESSING_REFLECTION_HPP
+
+/**
+ * @file Reflection.hpp
+ * @brief Registers the fields of a struct so the BinaryConverter serializes it as a single STRUCT value.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details A struct lists its fields with CES_FIELDS, which declares a ces_fields() member that returns them as a
+ * tuple of references. Writing a ces_fields() member by hand (const and non-const, returning std::tie of the fields)
+ * works the same way. The struct is written with one header, a signature of its field types and the payloads of
+ * its fields back to back. When the fields are single values that fill the struct without padding, in declaration
+ * order, the payload is a plain copy of the struct.
+ * @copyright CES Public License
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include "TypeDefinitions.hpp"
+
+/*
+ * Declares the fields of a struct, in the order they are serialized. Used inside the struct:
+ *     struct Tick { long time; double price; std::string symbol; CES_FIELDS(time, price, symbol) };
+ */
+#define CES_FIELDS(...) \
+    auto ces_fields() { return std::tie(__VA_ARGS__); } \
+    auto ces_fields() const { return std::tie(__VA_ARGS__); }
+
+namespace CES {
+    class Reflection {
+        static constexpr std::size_t index_not_found = static_cast<std::size_t>(-1);
+
+        template<typename T>
+        using fields_t = decltype(std::declval<const T &>().ces_fields());
+
+        template<typename Tuple, std::size_t... I>
+        static constexpr std::uint32_t hash_fields(std::uint32_t hash, std::index_sequence<I...>) {
+            ((hash = hash_field<std::remove_cvref_t<std::tuple_element_t<I, Tuple>>>(hash)), ...);
+            return hash;
+        }
+
+        /*
+         * FNV-1a over the type flag of the field, nested structs add their own fields.
+         */
+        template<typename Field>
+        static constexpr std::uint32_t hash_field(std::uint32_t hash) {
+            hash = (hash ^ static_cast<std::uint32_t>(type_tag_v<Field>)) * 16777619u;
+            if constexpr (type_tag_v<Field> == STRUCT) {
+                using Tuple = fields_t<Field>;
+                hash = hash_fields<Tuple>(hash, std::make_index_sequence<std::tuple_size_v<Tuple>>{});
+                hash = (hash ^ 0xFFu) * 16777619u; // closes the nested struct, so {a, {b}, c} differs from {a, {b, c}}.
+            }
+            return hash;
+        }
+
+        template<typename Tuple, std::size_t... I>
+        static constexpr bool packed_fields(std::index_sequence<I...>) {
+            return (is_packed_field<std::remove_cvref_t<std::tuple_element_t<I, Tuple>>>() && ...);
+        }
+
+        template<typename Field>
+        static constexpr bool is_packed_field() {
+            if constexpr (type_tag_v<Field> == STRUCT) return is_packed<Field>();
+            else return std::is_arithmetic_v<Field>;
+        }
+
+        template<typename T>
+        static constexpr std::size_t field_bytes() {
+            using Tuple = fields_t<T>;
+            return []<std::size_t... I>(std::index_sequence<I...>) {
+                return (sizeof(std::remove_cvref_t<std::tuple_element_t<I, Tuple>>) + ... + 0);
+            }(std::make_index_sequence<std::tuple_size_v<Tuple>>{});
+        }
+
+        template<typename Field>
+        static bool nested_in_memory_order(const Field &field) {
+            if constexpr (type_tag_v<Field> == STRUCT) return in_memory_order(field);
+            else return true;
+        }
+
+    public:
+
+        Reflection() = delete;
+
+        /*
+         * Identifies the field types of a struct, so data written for another struct is not read into it.
+         */
+        template<typename T>
+        static constexpr std::uint32_t signature() {
+            using Tuple = fields_t<T>;
+            return hash_fields<Tuple>(2166136261u, std::make_index_sequence<std::tuple_size_v<Tuple>>{});
+        }
+
+        /*
+         * True when every field is a single value or a packed struct, and together they fill the struct without
+         * padding. Whether the declaration order matches the order of CES_FIELDS is checked by in_memory_order.
+         */
+        template<typename T>
+        static constexpr bool is_packed() {
+            using Tuple = fields_t<T>;
+            if constexpr (!std::is_trivially_copyable_v<T>) return false;
+            else return packed_fields<Tuple>(std::make_index_sequence<std::tuple_size_v<Tuple>>{}) &&
+                        field_bytes<T>() == sizeof(T);
+        }
+
+        /*
+         * True when the fields of a packed struct follow each other in memory in the order they are serialized.
+         * The offsets are constants, the compiler folds this to true or false.
+         */
+        template<typename T>
+        static bool in_memory_order(const T &obj) {
+            const auto *base = reinterpret_cast<const std::byte *>(&obj);
+            std::size_t offset = 0;
+            bool ordered = true;
+            std::apply([&](const auto &...field) {
+                ((ordered = ordered && reinterpret_cast<const std::byte *>(&field) - base == static_cast<std::ptrdiff_t>(offset) &&
+                            nested_in_memory_order(field),
+                  offset += sizeof(field)), ...);
+            }, obj.ces_fields());
+            return ordered;
+        }
+
+        /*
+         * The position of a member in the registered fields of its struct, e.g. field_index(&Tick::price).
+         * The struct has to be default constructible, the position is found on a default constructed instance.
+         */
+        template<typename Record, typename Field>
+        static std::size_t field_index(Field Record::*member) {
+            static const Record probe{};
+            const void *address = &(probe.*member);
+            std::size_t index = 0;
+            std::size_t found = index_not_found;
+            std::apply([&](const auto &...field) {
+                ((found = found == index_not_found && static_cast<const void *>(&field) == address ? index : found, ++index), ...);
+            }, probe.ces_fields());
+            if (found == index_not_found) throw std::invalid_argument("The member is not a registered field of its struct");
+            return found;
+        }
+    };
+}
+#endif //BINARY_DATA_PROCESSING_REFLECTION_HPP
@@ -0,0 +1,364 @@
+#ifndef BINARY_DATA_PROCESSING_SERIESCODER_HPP
+#define BINARY_DATA_PROCESSING_SERIESCODER_HPP
+
+/**
+ * @file SeriesCoder.hpp
+ * @brief Contains the SeriesCoder class, the delta, delta-of-delta and XOR encodings of time series arrays.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details Consecutive values of a time series are close to each other, so they are stored relative to the value
+ * before. Integers keep the difference to the previous value (delta), or the difference between consecutive
+ * differences (delta of delta), which is 0 for evenly spaced timestamps. Floats and doubles keep the XOR of their
+ * bits with the previous value, as in Gorilla: readings that change little share the sign, the exponent and the high
+ * mantissa bits, which XOR to zeros.
+ *
+ * The first value (and the first difference for delta of delta) is stored whole, the rest are residuals in blocks of
+ * 128: the signed differences are zigzag mapped, and every block stores the bit width of its largest residual
+ * followed by all residuals at that width. Gorilla picks the window of meaningful XOR bits per value; here it is
+ * picked per block, a shift (the trailing zero bits every XOR of the block has) and a width, so that a block is
+ * decoded by the same fixed width unpack loop: one kernel per bit width, selected once per block. A block of evenly
+ * spaced timestamps or of repeated readings has width 0 and takes one byte.
+ *
+ * Everything is written in little endian byte order, bit i of the packed residuals is bit i % 8 of byte i / 8, so
+ * the encoded bytes are the same on every system.
+ * @copyright CES Public License
+ */
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "ByteSwap.hpp"
+
+namespace CES {
+    class SeriesCoder {
+    public:
+
+        /*
+         * The number of residuals that share one bit width.
+         */
+        static constexpr std::size_t block_size = 128;
+
+    private:
+
+        static std::uint64_t load_le(const unsigned char *in) {
+            std::uint64_t word;
+            std::memcpy(&word, in, sizeof(word));
+            if constexpr (std::endian::native == std::endian::big) word = ByteSwapper::swap(word);
+            return word;
+        }
+
+        static void store_le(std::uint64_t word, unsigned char *out, std::size_t bytes = 8) {
+            for (std::size_t i = 0; i < bytes; ++i) out[i] = static_cast<unsigned char>(word >> (8 * i));
+        }
+
+        static constexpr std::uint64_t zigzag(std::uint64_t x) {
+            return (x << 1) ^ static_cast<std::uint64_t>(static_cast<std::int64_t>(x) >> 63);
+        }
+
+        static constexpr std::uint64_t unzigzag(std::uint64_t z) { return (z >> 1) ^ (0 - (z & 1)); }
+
+        static constexpr std::size_t packed_bytes(std::size_t count, unsigned width) { return (count * width + 7) / 8; }
+
+        /*
+         * The value of an integer as 64 bits, sign extended for signed types, so the differences are the same.
+         */
+        template<typename T>
+        static std::uint64_t widen(T value) {
+            if constexpr (std::is_signed_v<T>) return static_cast<std::uint64_t>(static_cast<std::int64_t>(value));
+            else return static_cast<std::uint64_t>(value);
+        }
+
+        template<typename T>
+        using bits_t = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+
+        template<typename T>
+        static std::uint64_t bits_of(T value) { return std::bit_cast<bits_t<T>>(value); }
+
+        /*
+         * Residual i of a delta series, i >= order.
+         */
+        template<typename T>
+        static std::uint64_t delta_residual(const T *values, std::size_t i, unsigned order) {
+            const std::uint64_t delta = widen(values[i]) - widen(values[i - 1]);
+            if (order == 1) return zigzag(delta);
+            return zigzag(delta - (widen(values[i - 1]) - widen(values[i - 2])));
+        }
+
+        /*
+         * Appends count values of width bits to the bit stream of a block.
+         */
+        static unsigned char *pack(const std::uint64_t *values, std::size_t count, unsigned width, unsigned char *out) {
+            if (width == 0) return out;
+            std::uint64_t word = 0;
+            unsigned filled = 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                const std::uint64_t value = values[i];
+                word |= value << filled;
+                if (filled + width >= 64) {
+                    store_le(word, out);
+                    out += 8;
+                    const unsigned used = 64 - filled;
+                    word = used < 64 ? value >> used : 0;
+                    filled = filled + width - 64;
+                } else {
+                    filled += width;
+                }
+            }
+            store_le(word, out, (filled + 7) / 8);
+            return out + (filled + 7) / 8;
+        }
+
+        /*
+         * Reads the value at a bit position without reading past the end of the block.
+         */
+        static std::uint64_t load_bits(const unsigned char *in, std::size_t bytes, std::size_t bit, unsigned width) {
+            const std::size_t byte = bit / 8;
+            const unsigned shift = bit % 8;
+            std::uint64_t word = 0;
+            if (byte + 8 <= bytes) {
+                word = load_le(in + byte);
+            } else {
+                for (std::size_t i = 0; byte + i < bytes; ++i) word |= static_cast<std::uint64_t>(in[byte + i]) << (8 * i);
+            }
+            std::uint64_t value = word >> shift;
+            if (shift + width > 64) value |= static_cast<std::uint64_t>(in[byte + 8]) << (64 - shift);
+            return width == 64 ? value : value & ((std::uint64_t{1} << width) - 1);
+        }
+
+        /*
+         * Unpacks the values of a block whose 8 byte load (and the byte after it for widths above 56) stays inside
+         * the block, the rest one by one. The width is a constant, so the shifts and the mask are too.
+         */
+        template<unsigned Width>
+        static void unpack(const unsigned char *in, std::size_t bytes, std::size_t count, std::uint64_t *out) {
+            if constexpr (Width == 0) {
+                std::fill(out, out + count, std::uint64_t{0});
+            } else {
+                constexpr std::uint64_t mask = Width == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << Width) - 1;
+                constexpr std::size_t tail = Width > 56 ? 9 : 8;
+                std::size_t i = 0;
+                for (; i < count && (i * Width) / 8 + tail <= bytes; ++i) {
+                    const std::size_t bit = i * Width;
+                    const unsigned shift = bit % 8;
+                    std::uint64_t value = load_le(in + bit / 8) >> shift;
+                    if constexpr (Width > 56) {
+                        if (shift + Width > 64) value |= static_cast<std::uint64_t>(in[bit / 8 + 8]) << (64 - shift);
+                    }
+                    out[i] = value & mask;
+                }
+                for (; i < count; ++i) out[i] = load_bits(in, bytes, i * Width, Width);
+            }
+        }
+
+        using Unpacker = void (*)(const unsigned char *, std::size_t, std::size_t, std::uint64_t *);
+
+        template<std::size_t... Widths>
+        static constexpr std::array<Unpacker, sizeof...(Widths)> unpackers(std::index_sequence<Widths...>) {
+            return {&unpack<static_cast<unsigned>(Widths)>...};
+        }
+
+        /*
+         * Reads the width of a block and unpacks its residuals.
+         * @return the position after the block.
+         */
+        static const unsigned char *read_block(const unsigned char *in, const unsigned char *end, std::size_t count,
+                                               unsigned width, std::uint64_t *out) {
+            static constexpr std::array<Unpacker, 65> table = unpackers(std::make_index_sequence<65>{});
+            if (width > 64) throw std::runtime_error("Malformed time series block");
+            const std::size_t bytes = packed_bytes(count, width);
+            if (static_cast<std::size_t>(end - in) < bytes) throw std::runtime_error("Malformed time series block");
+            table[width](in, bytes, count, out);
+            return in + bytes;
+        }
+
+        static unsigned width_of(const std::uint64_t *values, std::size_t count) {
+            std::uint64_t all = 0;
+            for (std::size_t i = 0; i < count; ++i) all |= values[i];
+            return static_cast<unsigned>(std::bit_width(all));
+        }
+
+        /*
+         * The shift and width of a block of XORs: the trailing zeros they all have and the bits left above them.
+         */
+        static std::pair<unsigned, unsigned> window_of(const std::uint64_t *values, std::size_t count) {
+            std::uint64_t all = 0;
+            for (std::size_t i = 0; i < count; ++i) all |= values[i];
+            if (all == 0) return {0, 0};
+            const auto shift = static_cast<unsigned>(std::countr_zero(all));
+            return {shift, static_cast<unsigned>(std::bit_width(all >> shift))};
+        }
+
+        /*
+         * Calls f(first, count, residuals) for every block of residuals of a series.
+         */
+        template<typename Residual, typename F>
+        static void for_blocks(std::size_t begin, std::size_t end, Residual &&residual, F &&f) {
+            std::uint64_t block[block_size];
+            for (std::size_t first = begin; first < end; first += block_size) {
+                const std::size_t count = std::min(block_size, end - first);
+                for (std::size_t i = 0; i < count; ++i) block[i] = residual(first + i);
+                f(count, block);
+            }
+        }
+
+    public:
+
+        SeriesCoder() = delete;
+
+        /*
+         * The most bytes a series of count values can take, with every residual at 64 bits.
+         */
+        static constexpr std::size_t max_size(std::size_t count) {
+            return 2 * 8 + count * 8 + 2 * ((count + block_size - 1) / block_size);
+        }
+
+        /*
+         * The number of bytes encode_delta writes.
+         * @param order 1 for deltas, 2 for deltas of deltas.
+         */
+        template<typename T>
+        static std::size_t delta_size(const T *values, std::size_t count, unsigned order) {
+            std::size_t size = std::min<std::size_t>(count, order) * 8;
+            for_blocks(std::min<std::size_t>(count, order), count, [&](std::size_t i) { return delta_residual(values, i, order); },
+                       [&](std::size_t n, const std::uint64_t *block) { size += 1 + packed_bytes(n, width_of(block, n)); });
+            return size;
+        }
+
+        /*
+         * Writes an integer series as deltas (order 1) or deltas of deltas (order 2).
+         * @return the position after the encoded series.
+         */
+        template<typename T>
+        static unsigned char *encode_delta(const T *values, std::size_t count, unsigned order, unsigned char *out) {
+            if (count > 0) {
+                store_le(widen(values[0]), out);
+                out += 8;
+            }
+            if (order == 2 && count > 1) {
+                store_le(widen(values[1]) - widen(values[0]), out);
+                out += 8;
+            }
+            for_blocks(std::min<std::size_t>(count, order), count, [&](std::size_t i) { return delta_residual(values, i, order); },
+                       [&](std::size_t n, const std::uint64_t *block) {
+                           const unsigned width = width_of(block, n);
+                           *out++ = static_cast<unsigned char>(width);
+                           out = pack(block, n, width, out);
+                       });
+            return out;
+        }
+
+        /*
+         * Reads an integer series written by encode_delta straight into its destination.
+         * @param in the encoded series, bytes long.
+         * @param out room for count values.
+         */
+        template<typename T>
+        static void decode_delta(const unsigned char *in, std::size_t bytes, T *out, std::size_t count, unsigned order) {
+            const unsigned char *end = in + bytes;
+            const std::size_t head = std::min<std::size_t>(count, order);
+            if (bytes < head * 8) throw std::runtime_error("Malformed delta array");
+            std::uint64_t value = 0, delta = 0;
+            if (count > 0) {
+                value = load_le(in);
+                out[0] = static_cast<T>(value);
+                in += 8;
+            }
+            if (order == 2 && count > 1) {
+                delta = load_le(in);
+                value += delta;
+                out[1] = static_cast<T>(value);
+                in += 8;
+            }
+            std::uint64_t block[block_size];
+            for (std::size_t first = head; first < count; first += block_size) {
+                const std::size_t n = std::min(block_size, count - first);
+                if (in == end) throw std::runtime_error("Malformed delta array");
+                const unsigned width = *in++;
+                in = read_block(in, end, n, width, block);
+                T *destination = out + first;
+                if (order == 1) {
+                    for (std::size_t i = 0; i < n; ++i) destination[i] = static_cast<T>(value += unzigzag(block[i]));
+                } else {
+                    for (std::size_t i = 0; i < n; ++i) destination[i] = static_cast<T>(value += (delta += unzigzag(block[i])));
+                }
+            }
+            if (in != end) throw std::runtime_error("Malformed delta array");
+        }
+
+        /*
+         * The number of bytes encode_xor writes.
+         */
+        template<typename T>
+        static std::size_t xor_size(const T *values, std::size_t count) {
+            std::size_t size = count > 0 ? sizeof(T) : 0;
+            for_blocks(1, count, [&](std::size_t i) { return bits_of(values[i]) ^ bits_of(values[i - 1]); },
+                       [&](std::size_t n, const std::uint64_t *block) { size += 2 + packed_bytes(n, window_of(block, n).second); });
+            return size;
+        }
+
+        /*
+         * Writes a float or double series as the XOR of every value with the previous one.
+         * @return the position after the encoded series.
+         */
+        template<typename T>
+        static unsigned char *encode_xor(const T *values, std::size_t count, unsigned char *out) {
+            static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "Only floats and doubles are XOR encoded");
+            if (count > 0) {
+                store_le(bits_of(values[0]), out, sizeof(T));
+                out += sizeof(T);
+            }
+            for_blocks(1, count, [&](std::size_t i) { return bits_of(values[i]) ^ bits_of(values[i - 1]); },
+                       [&](std::size_t n, std::uint64_t *block) {
+                           const auto [shift, width] = window_of(block, n);
+                           *out++ = static_cast<unsigned char>(shift);
+                           *out++ = static_cast<unsigned char>(width);
+                           for (std::size_t i = 0; i < n; ++i) block[i] >>= shift;
+                           out = pack(block, n, width, out);
+                       });
+            return out;
+        }
+
+        /*
+         * Reads a float or double series written by encode_xor straight into its destination.
+         */
+        template<typename T>
+        static void decode_xor(const unsigned char *in, std::size_t bytes, T *out, std::size_t count) {
+            using Bits = bits_t<T>;
+            const unsigned char *end = in + bytes;
+            if (count == 0) {
+                if (bytes != 0) throw std::runtime_error("Malformed XOR float array");
+                return;
+            }
+            if (bytes < sizeof(T)) throw std::runtime_error("Malformed XOR float array");
+            std::uint64_t first = 0;
+            for (std::size_t i = 0; i < sizeof(T); ++i) first |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+            in += sizeof(T);
+            auto value = static_cast<Bits>(first);
+            out[0] = std::bit_cast<T>(value);
+
+            std::uint64_t block[block_size];
+            for (std::size_t first_index = 1; first_index < count; first_index += block_size) {
+                const std::size_t n = std::min(block_size, count - first_index);
+                if (end - in < 2) throw std::runtime_error("Malformed XOR float array");
+                const unsigned shift = in[0];
+                const unsigned width = in[1];
+                if (shift >= sizeof(T) * 8 || shift + width > sizeof(T) * 8) throw std::runtime_error("Malformed XOR float array");
+                in = read_block(in + 2, end, n, width, block);
+                T *destination = out + first_index;
+                for (std::size_t i = 0; i < n; ++i) {
+                    value ^= static_cast<Bits>(block[i] << shift);
+                    destination[i] = std::bit_cast<T>(value);
+                }
+            }
+            if (in != end) throw std::runtime_error("Malformed XOR float array");
+        }
+    };
+}
+#endif //BINARY_DATA_PROCESSING_SERIESCODER_HPP
@@ -0,0 +1,526 @@
+#ifndef BINARY_DATA_PROCESSING_SHAREDRING_HPP
+#define BINARY_DATA_PROCESSING_SHAREDRING_HPP
+
+/**
+ * @file SharedRing.hpp
+ * @brief Contains the SharedRingWriter and SharedRingReader classes, a single producer single consumer ring buffer
+ * in POSIX shared memory that passes serialized values between processes on the same machine.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details The writer creates a named shared memory object, the reader opens it by name. Every message is a value
+ * as BinaryConverter::serialize writes it, preceded by its size and padded to 8 bytes. The writer serializes straight
+ * into the ring and the reader deserializes straight out of it, no system call and no copy through the page cache.
+ * A message never wraps around the end of the ring, the writer marks the rest of the ring as padding and starts over
+ * at the front instead, so a message is always contiguous memory that views such as LazyArray can point into.
+ *
+ * The writer owns the head and the reader the tail, each keeps a copy of the other's position and only loads the
+ * shared one when its copy says the ring is full or empty: writing into a ring with room and reading from a ring with
+ * messages is a handful of plain loads and one release store. A side that has to wait spins briefly and then sleeps
+ * on a futex, the other side only makes the wake up call when it sees that someone sleeps. Other POSIX systems have no
+ * shared futex and sleep for short intervals instead.
+ * @copyright CES Public License
+ */
+
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include "BinaryConverter.hpp"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+namespace CES {
+    /*
+     * The mapping of a shared ring and the waiting and waking both sides use. Used by the SharedRingWriter and the
+     * SharedRingReader.
+     */
+    class SharedRing {
+    public:
+
+        /*
+         * The start of the shared memory. The positions are byte counts since the ring was created, they only grow.
+         * The members each side writes are on a cache line of their own.
+         */
+        struct Control {
+            char magic[4];
+            std::uint8_t version;
+            std::uint8_t system;
+            std::uint64_t capacity; // bytes of the data region, a power of two.
+            std::int64_t writer; // the process id of the writer, tells whether a ring that was left behind is in use.
+
+            alignas(64) std::atomic<std::uint64_t> head; // written by the writer: the end of the published messages.
+            std::atomic<std::uint32_t> readable; // bumped to wake the reader.
+            std::atomic<std::uint32_t> writer_closed;
+
+            alignas(64) std::atomic<std::uint64_t> tail; // written by the reader: the end of the released messages.
+            std::atomic<std::uint32_t> writable; // bumped to wake the writer.
+            std::atomic<std::uint32_t> reader_closed;
+
+            alignas(64) std::atomic<std::uint32_t> reader_waiting;
+            std::atomic<std::uint32_t> writer_waiting;
+        };
+
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free && std::atomic<std::uint32_t>::is_always_lock_free,
+                      "The shared ring needs lock free atomics, they are shared between processes");
+
+        /*
+         * Identifies a shared ring: "CESQ", followed by the format version.
+         */
+        static constexpr char magic[4] = {'C', 'E', 'S', 'Q'};
+        static constexpr std::uint8_t version = 2;
+        static constexpr std::size_t data_offset = (sizeof(Control) + 63) & ~std::size_t{63};
+
+        /*
+         * Every message starts with its size, a size of padding_marker means that the rest of the ring is unused.
+         */
+        static constexpr std::size_t record_header = sizeof(std::uint64_t);
+        static constexpr std::uint64_t padding_marker = std::numeric_limits<std::uint64_t>::max();
+
+        static constexpr std::size_t stride(std::size_t message) { return (record_header + message + 7) & ~std::size_t{7}; }
+
+    private:
+
+        void *address = nullptr;
+        std::size_t length = 0;
+        std::string shm_name;
+
+        /*
+         * Shared memory object names start with a single slash.
+         */
+        static std::string shm_path(const std::string &name) { return name.starts_with('/') ? name : '/' + name; }
+
+        /*
+         * True when path names a shared ring whose writer process has exited without removing it.
+         */
+        static bool abandoned(const std::string &path) {
+            const int fd = shm_open(path.c_str(), O_RDONLY, 0);
+            if (fd < 0) return false;
+            struct stat st{};
+            const bool sized = fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= sizeof(Control);
+            void *mapped = sized ? mmap(nullptr, sizeof(Control), PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+            ::close(fd);
+            if (mapped == MAP_FAILED) return false;
+            const auto *c = static_cast<const Control *>(mapped);
+            const bool ring = std::memcmp(c->magic, magic, sizeof(magic)) == 0 && c->version == version;
+            const auto writer = static_cast<pid_t>(c->writer);
+            munmap(mapped, sizeof(Control));
+            return ring && writer > 0 && kill(writer, 0) != 0 && errno == ESRCH;
+        }
+
+        void map(int fd, std::size_t size) {
+            void *mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            ::close(fd); // the mapping keeps its own reference to the object.
+            if (mapped == MAP_FAILED) throw std::runtime_error("Could not map shared ring: " + shm_name);
+            address = mapped;
+            length = size;
+        }
+
+    public:
+
+        /*
+         * Creates the shared memory object. A ring of that name whose writer still runs is left alone, one that a
+         * writer which crashed left behind is replaced.
+         * @param capacity the bytes of the data region, rounded up to a power of two.
+         */
+        SharedRing(const std::string &name, std::size_t capacity) : shm_name(shm_path(name)) {
+            capacity = std::bit_ceil(std::max<std::size_t>(capacity, 4096));
+            int fd = shm_open(shm_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+            if (fd < 0 && errno == EEXIST && abandoned(shm_name)) {
+                shm_unlink(shm_name.c_str());
+                fd = shm_open(shm_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+            }
+            if (fd < 0 && errno == EEXIST) throw std::runtime_error("Shared ring is in use: " + shm_name);
+            if (fd < 0) throw std::runtime_error("Could not create shared ring: " + shm_name);
+            if (ftruncate(fd, static_cast<off_t>(data_offset + capacity)) != 0) {
+                ::close(fd);
+                shm_unlink(shm_name.c_str());
+                throw std::runtime_error("Could not size shared ring: " + shm_name);
+            }
+            try {
+                map(fd, data_offset + capacity);
+            } catch (...) {
+                shm_unlink(shm_name.c_str());
+                throw;
+            }
+            Control *c = new(address) Control{}; // the memory of a new object is zero, the constructor only makes it official.
+            c->version = version;
+            c->system = static_cast<std::uint8_t>(BinaryConverter::detect_system_type());
+            c->capacity = capacity;
+            c->writer = getpid();
+            std::memcpy(c->magic, magic, sizeof(magic));
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        /*
+         * Opens the shared memory object a writer created.
+         */
+        explicit SharedRing(const std::string &name) : shm_name(shm_path(name)) {
+            const int fd = shm_open(shm_name.c_str(), O_RDWR, 0);
+            if (fd < 0) throw std::runtime_error("Could not open shared ring: " + shm_name);
+            struct stat st{};
+            if (fstat(fd, &st) != 0) {
+                ::close(fd);
+                throw std::runtime_error("Could not stat shared ring: " + shm_name);
+            }
+            const auto size = static_cast<std::size_t>(st.st_size);
+            if (size < data_offset) {
+                ::close(fd);
+                throw std::invalid_argument("Not a shared ring: " + shm_name);
+            }
+            map(fd, size);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const Control &c = control();
+            if (std::memcmp(c.magic, magic, sizeof(magic)) != 0 || c.version != version || !std::has_single_bit(c.capacity) ||
+                c.capacity != size - data_offset) {
+                unmap();
+                throw std::invalid_argument("Not a shared ring: " + shm_name);
+            }
+        }
+
+        ~SharedRing() { unmap(); }
+
+        SharedRing(const SharedRing &) = delete;
+        SharedRing &operator=(const SharedRing &) = delete;
+
+        void unmap() {
+            if (address) munmap(address, length);
+            address = nullptr;
+            length = 0;
+        }
+
+        /*
+         * Removes the name, the mappings that exist stay valid.
+         */
+        void unlink() const { shm_unlink(shm_name.c_str()); }
+
+        [[nodiscard]] Control &control() const { return *static_cast<Control *>(address); }
+
+        [[nodiscard]] std::byte *data() const { return static_cast<std::byte *>(address) + data_offset; }
+
+        [[nodiscard]] std::size_t capacity() const { return control().capacity; }
+
+        /*
+         * Sleeps while word still holds expected. May return early, callers check their condition again.
+         */
+        static void sleep(std::atomic<std::uint32_t> &word, std::uint32_t expected) {
+#ifdef __linux__
+            // not FUTEX_WAIT_PRIVATE: the word is shared with another process.
+            syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAIT, expected, nullptr, nullptr, 0);
+#else
+            if (word.load(std::memory_order_relaxed) == expected) std::this_thread::sleep_for(std::chrono::microseconds(50));
+#endif
+        }
+
+        /*
+         * Wakes the other side when it sleeps on word, its waiting flag tells. Called after the position it waits for
+         * was stored.
+         */
+        static void wake(std::atomic<std::uint32_t> &word, std::atomic<std::uint32_t> &waiting) {
+            std::atomic_thread_fence(std::memory_order_seq_cst); // orders the position store before the flag load.
+            if (waiting.load(std::memory_order_relaxed) == 0) return;
+            word.fetch_add(1, std::memory_order_relaxed);
+#ifdef __linux__
+            syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#endif
+        }
+
+        /*
+         * Waits until ready() is true or stop() is. Spins a little first, a message is often only microseconds away.
+         * @return the last result of ready().
+         */
+        template<typename Ready, typename Stop>
+        static bool wait(std::atomic<std::uint32_t> &word, std::atomic<std::uint32_t> &waiting, Ready &&ready, Stop &&stop) {
+            for (int spin = 0; spin < 64; ++spin) {
+                if (ready()) return true;
+                if (stop()) return false;
+                std::this_thread::yield();
+            }
+            while (true) {
+                const std::uint32_t expected = word.load(std::memory_order_relaxed);
+                waiting.store(1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst); // orders the flag store before the position load.
+                const bool done = ready() || stop();
+                if (!done) sleep(word, expected);
+                waiting.store(0, std::memory_order_relaxed);
+                if (done) return ready();
+            }
+        }
+    };
+
+    class SharedRingWriter {
+        SharedRing ring;
+        SharedRing::Control &control;
+        std::uint64_t head = 0;
+        std::uint64_t tail = 0; // the last tail loaded, the reader has released at least this much.
+        std::size_t mask;
+        bool closed = false;
+
+        /*
+         * Makes sure that count bytes from the head on are free.
+         * @param block false to give up at once instead of waiting for the reader.
+         */
+        bool room(std::size_t count, bool block) {
+            const std::size_t capacity = mask + 1;
+            if (head + count - tail <= capacity) return true; // the fast path: the copy of the tail says so.
+            const auto free = [&] {
+                tail = control.tail.load(std::memory_order_acquire);
+                return head + count - tail <= capacity;
+            };
+            if (free()) return true;
+            if (!block) return false;
+            const auto gone = [&] { return control.reader_closed.load(std::memory_order_acquire) != 0; };
+            if (SharedRing::wait(control.writable, control.writer_waiting, free, gone))
+                return true;
+            throw std::runtime_error("The reader of the shared ring is gone");
+        }
+
+        void publish() {
+            control.head.store(head, std::memory_order_release);
+            SharedRing::wake(control.readable, control.reader_waiting);
+        }
+
+        /*
+         * Reserves a contiguous record for a message of size bytes.
+         * @return where the message goes, nullptr when block is false and the ring is full.
+         */
+        std::byte *reserve(std::size_t size, bool block) {
+            if (closed) throw std::logic_error("The shared ring is closed");
+            const std::size_t record = SharedRing::stride(size);
+            if (record > mask + 1)
+                throw std::invalid_argument("Message is larger than the shared ring. Required size: " + std::to_string(record));
+            const std::size_t offset = head & mask;
+            if (mask + 1 - offset < record) { // does not fit before the end: pad and start over at the front.
+                if (!room(mask + 1 - offset, block)) return nullptr;
+                std::memcpy(ring.data() + offset, &SharedRing::padding_marker, SharedRing::record_header);
+                head += mask + 1 - offset;
+                publish();
+            }
+            if (!room(record, block)) return nullptr;
+            const std::uint64_t length = size;
+            std::byte *out = ring.data() + (head & mask);
+            std::memcpy(out, &length, SharedRing::record_header);
+            return out + SharedRing::record_header;
+        }
+
+    public:
+
+        /*
+         * Creates the shared ring. Readers can open it by name from now on. Throws when a writer that still runs has
+         * a ring of that name.
+         * @param name the name of the shared memory object, for example "/ces_ticks".
+         * @param capacity the bytes of the ring, rounded up to a power of two. The largest message is a bit smaller.
+         */
+        explicit SharedRingWriter(const std::string &name, std::size_t capacity = 1 << 20)
+                : ring(name, capacity), control(ring.control()), mask(ring.capacity() - 1) {}
+
+        /*
+         * Closes the ring and removes its name. A reader that has it open reads the messages that are left.
+         */
+        ~SharedRingWriter() {
+            close();
+            ring.unlink();
+        }
+
+        SharedRingWriter(const SharedRingWriter &) = delete;
+        SharedRingWriter &operator=(const SharedRingWriter &) = delete;
+
+        /*
+         * Writes a message, waiting while the ring is full. Accepts everything BinaryConverter::serialize accepts.
+         * @param obj the value that is going to be written.
+         */
+        template<typename T>
+        void write(const T &obj) {
+            const std::size_t size = BinaryConverter::size_of(obj);
+            BinaryConverter::serialize_into(obj, std::span<std::byte>(reserve(size, true), size));
+            head += SharedRing::stride(size);
+            publish();
+        }
+
+        template<typename T, std::size_t N>
+        void write(const T (&arr)[N]) { write<T[N]>(arr); }
+
+        /*
+         * Writes a message when the ring has room for it now.
+         * @return false when it does not, nothing was written.
+         */
+        template<typename T>
+        bool try_write(const T &obj) {
+            const std::size_t size = BinaryConverter::size_of(obj);
+            std::byte *out = reserve(size, false);
+            if (!out) return false;
+            BinaryConverter::serialize_into(obj, std::span<std::byte>(out, size));
+            head += SharedRing::stride(size);
+            publish();
+            return true;
+        }
+
+        /*
+         * Tells the reader that no more messages come.
+         */
+        void close() {
+            if (closed) return;
+            closed = true;
+            control.writer_closed.store(1, std::memory_order_release);
+            SharedRing::wake(control.readable, control.reader_waiting);
+        }
+
+        /*
+         * The bytes of the ring.
+         */
+        [[nodiscard]] std::size_t capacity() const { return mask + 1; }
+    };
+
+    class SharedRingReader {
+        SharedRing ring;
+        SharedRing::Control &control;
+        std::uint64_t tail = 0;
+        std::uint64_t head = 0; // the last head loaded, the writer has published at least this much.
+        std::size_t mask;
+        std::span<const std::byte> current;
+        bool pending = false; // the current message was not released yet.
+
+        /*
+         * Moves past padding and checks that a message is published.
+         */
+        bool available() {
+            while (true) {
+                if (tail == head) {
+                    head = control.head.load(std::memory_order_acquire);
+                    if (tail == head) return false;
+                }
+                std::uint64_t size;
+                std::memcpy(&size, ring.data() + (tail & mask), SharedRing::record_header);
+                if (size != SharedRing::padding_marker) return true;
+                tail += mask + 1 - (tail & mask);
+                control.tail.store(tail, std::memory_order_release);
+                SharedRing::wake(control.writable, control.writer_waiting);
+            }
+        }
+
+        void release() {
+            if (!pending) return;
+            tail += SharedRing::stride(current.size());
+            control.tail.store(tail, std::memory_order_release);
+            SharedRing::wake(control.writable, control.writer_waiting);
+            pending = false;
+        }
+
+        void take() {
+            std::uint64_t size;
+            const std::byte *record = ring.data() + (tail & mask);
+            std::memcpy(&size, record, SharedRing::record_header);
+            // at least the system and type flags, and within the ring.
+            if (size < 2 || size > mask + 1 - (tail & mask) - SharedRing::record_header) throw std::runtime_error("Corrupted shared ring");
+            current = std::span<const std::byte>(record + SharedRing::record_header, size);
+            pending = true;
+        }
+
+    public:
+
+        /*
+         * Opens a shared ring created by a SharedRingWriter.
+         * @param name the name the writer was given.
+         */
+        explicit SharedRingReader(const std::string &name) : ring(name), control(ring.control()), mask(ring.capacity() - 1) {
+            tail = control.tail.load(std::memory_order_acquire);
+            head = tail;
+            control.reader_closed.store(0, std::memory_order_release); // a reader that detached before is replaced.
+        }
+
+        /*
+         * Lets a writer that waits for room know that nobody reads anymore.
+         */
+        ~SharedRingReader() {
+            control.reader_closed.store(1, std::memory_order_release);
+            SharedRing::wake(control.writable, control.writer_waiting);
+        }
+
+        SharedRingReader(const SharedRingReader &) = delete;
+        SharedRingReader &operator=(const SharedRingReader &) = delete;
+
+        /*
+         * Releases the current message and waits for the next one.
+         * @return false when the writer closed the ring and every message was read.
+         */
+        bool next() {
+            release();
+            const auto ready = [&] { return available(); };
+            const auto closed = [&] { return control.writer_closed.load(std::memory_order_acquire) != 0; };
+            if (!available() && !SharedRing::wait(control.readable, control.reader_waiting, ready, closed)) return false;
+            take();
+            return true;
+        }
+
+        /*
+         * Releases the current message and moves to the next one when it was already published.
+         * @return false when there is none yet.
+         */
+        bool try_next() {
+            release();
+            if (!available()) return false;
+            take();
+            return true;
+        }
+
+        /*
+         * The bytes of the current message, a value as BinaryConverter::serialize writes it. They stay valid until
+         * the next call to next or try_next.
+         */
+        [[nodiscard]] std::span<const std::byte> message() const { return current; }
+
+        /*
+         * The type flag of the current message.
+         */
+        [[nodiscard]] type current_type() const {
+            if (!pending) throw std::logic_error("No current message, call next first");
+            return static_cast<type>(current[1]);
+        }
+
+        /*
+         * Deserializes the current message, straight from the shared memory.
+         * @param obj the object to be deserialized, its type has to match the type flag of the message.
+         */
+        template<typename T>
+        void read(T &obj) {
+            if (!pending) throw std::logic_error("No current message, call next first");
+            BinaryConverter::deserialize(obj, current);
+        }
+
+        template<typename T, std::size_t N>
+        void read(T (&arr)[N]) {
+            if (!pending) throw std::logic_error("No current message, call next first");
+            BinaryConverter::deserialize(arr, current);
+        }
+
+        /*
+         * Reads the current message as a value of type T.
+         */
+        template<typename T>
+        T get() {
+            T obj{};
+            read(obj);
+            return obj;
+        }
+    };
+}
+#endif //BINARY_DATA_PROCESSING_SHAREDRING_HPP
@@ -0,0 +1,263 @@
+#ifndef BINARY_DATA_PROCESSING_STATS_HPP
+#define BINARY_DATA_PROCESSING_STATS_HPP
+
+/**
+ * @file Stats.hpp
+ * @brief Contains the opt-in counters of the BinaryConverter: values and bytes per type flag, byte swapped values
+ * and latency histograms of serialize and deserialize.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details Compiled in only when CES_STATS is defined to 1 (the CES_STATS CMake option), every translation unit
+ * has to agree on it. Without it the hooks are empty inline functions and the Timer an empty struct, nothing is
+ * measured and nothing is stored.
+ *
+ * Every thread counts into its own block of counters, the only writer of a counter is its thread, so a count is a
+ * relaxed load and store with no lock and no contended cache line. snapshot() sums the blocks of the running
+ * threads and what the finished threads left behind, a monitoring thread can call it at any time.
+ * @copyright CES Public License
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "TypeDefinitions.hpp"
+
+#ifndef CES_STATS
+#define CES_STATS 0
+#endif
+
+namespace CES {
+    /*
+     * The counters of one type flag.
+     */
+    struct TypeCounters {
+        std::uint64_t serialized = 0; // values written.
+        std::uint64_t deserialized = 0; // values read.
+        std::uint64_t bytes_written = 0; // headers included.
+        std::uint64_t bytes_read = 0;
+        std::uint64_t swapped = 0; // values read that were written with the other byte order.
+    };
+
+    /*
+     * Call durations in power of two buckets: bucket 0 counts calls under 1 ns, bucket i calls of [2^(i-1), 2^i) ns.
+     * The last bucket also takes everything longer.
+     */
+    struct LatencyHistogram {
+        static constexpr std::size_t bucket_count = 40;
+
+        std::array<std::uint64_t, bucket_count> buckets{};
+
+        static constexpr std::size_t bucket_of(std::uint64_t ns) {
+            return std::min<std::size_t>(std::bit_width(ns), bucket_count - 1);
+        }
+
+        /*
+         * The first duration in ns that no longer falls into bucket i.
+         */
+        static constexpr std::uint64_t upper_bound_ns(std::size_t i) { return std::uint64_t{1} << i; }
+
+        [[nodiscard]] std::uint64_t count() const {
+            std::uint64_t total = 0;
+            for (const std::uint64_t n: buckets) total += n;
+            return total;
+        }
+
+        /*
+         * The upper bound of the bucket that holds the given fraction of the calls, e.g. 0.99, 0 for no calls.
+         */
+        [[nodiscard]] std::uint64_t percentile_ns(double fraction) const {
+            const std::uint64_t total = count();
+            std::uint64_t seen = 0;
+            for (std::size_t i = 0; i < bucket_count; ++i) {
+                seen += buckets[i];
+                if (total != 0 && static_cast<double>(seen) >= fraction * static_cast<double>(total)) return upper_bound_ns(i);
+            }
+            return 0;
+        }
+    };
+
+    /*
+     * The sum of the counters of every thread at one moment.
+     */
+    struct StatsSnapshot {
+        std::array<TypeCounters, type_count> types{};
+        LatencyHistogram serialize_latency;
+        LatencyHistogram deserialize_latency;
+
+        /*
+         * The counters of one type flag.
+         */
+        [[nodiscard]] const TypeCounters &operator[](type t) const { return types[t]; }
+
+        /*
+         * The counters of every type flag added up.
+         */
+        [[nodiscard]] TypeCounters total() const {
+            TypeCounters sum;
+            for (const TypeCounters &c: types) {
+                sum.serialized += c.serialized;
+                sum.deserialized += c.deserialized;
+                sum.bytes_written += c.bytes_written;
+                sum.bytes_read += c.bytes_read;
+                sum.swapped += c.swapped;
+            }
+            return sum;
+        }
+
+        /*
+         * What was counted between an earlier snapshot and this one, for exporting rates.
+         */
+        [[nodiscard]] StatsSnapshot since(const StatsSnapshot &earlier) const {
+            StatsSnapshot delta = *this;
+            for (std::size_t t = 0; t < types.size(); ++t) {
+                delta.types[t].serialized -= earlier.types[t].serialized;
+                delta.types[t].deserialized -= earlier.types[t].deserialized;
+                delta.types[t].bytes_written -= earlier.types[t].bytes_written;
+                delta.types[t].bytes_read -= earlier.types[t].bytes_read;
+                delta.types[t].swapped -= earlier.types[t].swapped;
+            }
+            for (std::size_t i = 0; i < LatencyHistogram::bucket_count; ++i) {
+                delta.serialize_latency.buckets[i] -= earlier.serialize_latency.buckets[i];
+                delta.deserialize_latency.buckets[i] -= earlier.deserialize_latency.buckets[i];
+            }
+            return delta;
+        }
+    };
+
+    class Stats {
+#if CES_STATS
+        static constexpr std::size_t fields = 5; // the members of TypeCounters.
+
+        /*
+         * The counters of one thread. Only that thread writes them.
+         */
+        struct ThreadCounters {
+            std::atomic<std::uint64_t> types[type_count][fields]{};
+            std::atomic<std::uint64_t> serialize_latency[LatencyHistogram::bucket_count]{};
+            std::atomic<std::uint64_t> deserialize_latency[LatencyHistogram::bucket_count]{};
+
+            void add_to(StatsSnapshot &snapshot) const {
+                for (std::size_t t = 0; t < type_count; ++t) {
+                    TypeCounters &c = snapshot.types[t];
+                    c.serialized += types[t][0].load(std::memory_order_relaxed);
+                    c.deserialized += types[t][1].load(std::memory_order_relaxed);
+                    c.bytes_written += types[t][2].load(std::memory_order_relaxed);
+                    c.bytes_read += types[t][3].load(std::memory_order_relaxed);
+                    c.swapped += types[t][4].load(std::memory_order_relaxed);
+                }
+                for (std::size_t i = 0; i < LatencyHistogram::bucket_count; ++i) {
+                    snapshot.serialize_latency.buckets[i] += serialize_latency[i].load(std::memory_order_relaxed);
+                    snapshot.deserialize_latency.buckets[i] += deserialize_latency[i].load(std::memory_order_relaxed);
+                }
+            }
+        };
+
+        struct Registry {
+            std::mutex mutex;
+            std::vector<const ThreadCounters *> threads;
+            StatsSnapshot finished; // what the threads that ended counted.
+        };
+
+        static Registry &registry() {
+            static Registry instance;
+            return instance;
+        }
+
+        /*
+         * Registers the counters of a thread with its first count and hands them to the registry when it ends.
+         */
+        struct ThreadSlot {
+            ThreadCounters counters;
+
+            ThreadSlot() {
+                Registry &r = registry();
+                const std::lock_guard<std::mutex> lock(r.mutex);
+                r.threads.push_back(&counters);
+            }
+
+            ~ThreadSlot() {
+                Registry &r = registry();
+                const std::lock_guard<std::mutex> lock(r.mutex);
+                counters.add_to(r.finished);
+                std::erase(r.threads, &counters);
+            }
+        };
+
+        static ThreadCounters &local() {
+            thread_local ThreadSlot slot;
+            return slot.counters;
+        }
+
+        static void add(std::atomic<std::uint64_t> &counter, std::uint64_t n) {
+            counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); // single writer.
+        }
+
+        static std::uint64_t elapsed_ns(std::chrono::steady_clock::time_point start) {
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        }
+#endif
+
+    public:
+
+        Stats() = delete;
+
+        static constexpr bool enabled = CES_STATS;
+
+        /*
+         * Takes the start time of a call when the counters are compiled in, nothing otherwise.
+         */
+        struct Timer {
+#if CES_STATS
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#endif
+        };
+
+        /*
+         * Counts a serialized value.
+         */
+        static void record_serialize([[maybe_unused]] type t, [[maybe_unused]] std::size_t bytes, [[maybe_unused]] const Timer &timer) {
+#if CES_STATS
+            ThreadCounters &c = local();
+            add(c.types[t][0], 1);
+            add(c.types[t][2], bytes);
+            add(c.serialize_latency[LatencyHistogram::bucket_of(elapsed_ns(timer.start))], 1);
+#endif
+        }
+
+        /*
+         * Counts a deserialized value.
+         */
+        static void record_deserialize([[maybe_unused]] type t, [[maybe_unused]] std::size_t bytes, [[maybe_unused]] bool swapped,
+                                       [[maybe_unused]] const Timer &timer) {
+#if CES_STATS
+            ThreadCounters &c = local();
+            add(c.types[t][1], 1);
+            add(c.types[t][3], bytes);
+            if (swapped) add(c.types[t][4], 1);
+            add(c.deserialize_latency[LatencyHistogram::bucket_of(elapsed_ns(timer.start))], 1);
+#endif
+        }
+
+        /*
+         * The counters of every thread since the start of the program, all zero when they are not compiled in.
+         */
+        static StatsSnapshot snapshot() {
+            StatsSnapshot snapshot;
+#if CES_STATS
+            Registry &r = registry();
+            const std::lock_guard<std::mutex> lock(r.mutex);
+            snapshot = r.finished;
+            for (const ThreadCounters *counters: r.threads) counters->add_to(snapshot);
+#endif
+            return snapshot;
+        }
+    };
+}
+#endif //BINARY_DATA_PROCESSING_STATS_HPP
@@ -0,0 +1,236 @@
+#ifndef BINARY_DATA_PROCESSING_STRINGDICTIONARY_HPP
+#define BINARY_DATA_PROCESSING_STRINGDICTIONARY_HPP
+
+/**
+ * @file StringDictionary.hpp
+ * @brief Contains the dictionary encoding of string arrays: the CES::dictionary writer and the CodedStrings reader.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details Columns of hostnames, status codes or tenant ids repeat a few distinct values. A DICTIONARY_STRING_ARRAY
+ * stores every distinct string once, in the order they first appear, followed by one code per element, the index of
+ * its string in the dictionary. The codes take 1, 2 or 4 bytes, depending on the size of the dictionary.
+ *
+ * BinaryConverter::serialize(CES::dictionary(hosts), ostream) builds the dictionary with a hash map and writes a
+ * plain STRING_ARRAY instead when that is not larger, so strings that hardly repeat cost nothing extra. Reading into a
+ * std::vector<std::string> or a StringTable accepts both type flags and materializes the strings, reading into
+ * CodedStrings keeps the codes and the dictionary, so that equality filters compare integers.
+ * @copyright CES Public License
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "StringTable.hpp"
+#include "TypeDefinitions.hpp"
+
+namespace CES {
+    class BinaryConverter;
+
+    /*
+     * The layout of a DICTIONARY_STRING_ARRAY payload: the count, the number of distinct strings, the width of a
+     * code, the distinct strings with their length prefixes and the codes, all in the byte order of the writer.
+     */
+    class DictionaryLayout {
+    public:
+
+        DictionaryLayout() = delete;
+
+        static constexpr std::size_t header_size = 2 * sizeof(std::size_t) + 1;
+
+        /*
+         * The smallest code width that holds every index of a dictionary of unique strings.
+         */
+        static constexpr unsigned code_width(std::size_t unique) {
+            return unique <= 0x100 ? 1 : unique <= 0x10000 ? 2 : 4;
+        }
+
+        template<typename Strings>
+        static std::size_t size(std::size_t count, const Strings &unique) {
+            std::size_t size = header_size + count * code_width(std::size(unique));
+            for (const auto &string: unique) size += sizeof(std::size_t) + std::string_view(string).size();
+            return size;
+        }
+
+        /*
+         * Writes the payload.
+         * @param unique the distinct strings, codes index them.
+         * @return the position after the payload.
+         */
+        template<typename Strings>
+        static std::byte *encode(const Strings &unique, const std::vector<std::uint32_t> &codes, std::byte *out) {
+            const std::size_t count = codes.size(), distinct = std::size(unique);
+            const unsigned width = code_width(distinct);
+            std::memcpy(out, &count, sizeof(std::size_t));
+            std::memcpy(out + sizeof(std::size_t), &distinct, sizeof(std::size_t));
+            out[2 * sizeof(std::size_t)] = static_cast<std::byte>(width);
+            out += header_size;
+            for (const auto &element: unique) {
+                const std::string_view string(element);
+                const std::size_t length = string.size();
+                std::memcpy(out, &length, sizeof(std::size_t));
+                if (length != 0) std::memcpy(out + sizeof(std::size_t), string.data(), length);
+                out += sizeof(std::size_t) + length;
+            }
+            for (const std::uint32_t code: codes) { // narrowed to the code width, native byte order.
+                if (width == 1) {
+                    *out = static_cast<std::byte>(code);
+                } else if (width == 2) {
+                    const auto narrow = static_cast<std::uint16_t>(code);
+                    std::memcpy(out, &narrow, 2);
+                } else {
+                    std::memcpy(out, &code, 4);
+                }
+                out += width;
+            }
+            return out;
+        }
+    };
+
+    /*
+     * Writes an array or container of strings with a dictionary (see the file comment). The dictionary is built when
+     * the wrapper is created, keep the wrapper when the size is asked for before serializing.
+     */
+    template<typename Container>
+    class DictionaryStrings {
+        const Container &strings;
+        std::vector<std::string_view> unique; // in the order they first appear.
+        std::vector<std::uint32_t> codes;
+        std::size_t plain_size = sizeof(std::size_t);
+        bool coded = false;
+
+    public:
+
+        explicit DictionaryStrings(const Container &strings) : strings(strings) {
+            const std::size_t count = std::size(strings);
+            std::unordered_map<std::string_view, std::uint32_t> index;
+            codes.reserve(count);
+            for (const auto &element: strings) {
+                const std::string_view string(element);
+                plain_size += sizeof(std::size_t) + string.size();
+                if (unique.size() > std::numeric_limits<std::uint32_t>::max()) continue;
+                const auto [position, added] = index.try_emplace(string, static_cast<std::uint32_t>(unique.size()));
+                if (added) unique.push_back(string);
+                codes.push_back(position->second);
+                // mostly distinct after the first thousand strings: the dictionary would not pay off, stop hashing.
+                if (codes.size() == 1024 && unique.size() * 4 > codes.size() * 3) break;
+            }
+            coded = codes.size() == count && DictionaryLayout::size(count, unique) < plain_size;
+            if (!coded) {
+                plain_size = sizeof(std::size_t);
+                for (const auto &element: strings) plain_size += sizeof(std::size_t) + std::string_view(element).size();
+                unique = {};
+                codes = {};
+            }
+        }
+
+        /*
+         * DICTIONARY_STRING_ARRAY, or STRING_ARRAY when the dictionary does not make the payload smaller.
+         */
+        [[nodiscard]] type type_flag() const { return coded ? DICTIONARY_STRING_ARRAY : STRING_ARRAY; }
+
+        /*
+         * The number of distinct strings, 0 when the strings are written plain.
+         */
+        [[nodiscard]] std::size_t dictionary_size() const { return unique.size(); }
+
+        [[nodiscard]] std::size_t payload_size() const {
+            return coded ? DictionaryLayout::size(codes.size(), unique) : plain_size;
+        }
+
+        std::byte *encode_payload(std::byte *out) const {
+            if (coded) return DictionaryLayout::encode(unique, codes, out);
+            const std::size_t count = std::size(strings);
+            std::memcpy(out, &count, sizeof(std::size_t)); // the payload of a STRING_ARRAY.
+            out += sizeof(std::size_t);
+            for (const auto &element: strings) {
+                const std::string_view string(element);
+                const std::size_t length = string.size();
+                std::memcpy(out, &length, sizeof(std::size_t));
+                if (length != 0) std::memcpy(out + sizeof(std::size_t), string.data(), length);
+                out += sizeof(std::size_t) + length;
+            }
+            return out;
+        }
+    };
+
+    template<typename Container>
+    DictionaryStrings<Container> dictionary(const Container &strings) { return DictionaryStrings<Container>(strings); }
+
+    /*
+     * A deserialized string array kept as a dictionary and one code per string. A plain STRING_ARRAY is read too, the
+     * dictionary is then built while reading.
+     */
+    class CodedStrings {
+        StringTable strings;
+        std::vector<std::uint32_t> indices;
+
+        friend class BinaryConverter;
+
+    public:
+
+        CodedStrings() = default;
+
+        /*
+         * Number of strings, not of distinct strings.
+         */
+        [[nodiscard]] std::size_t size() const { return indices.size(); }
+
+        [[nodiscard]] bool empty() const { return indices.empty(); }
+
+        /*
+         * String i, looked up in the dictionary.
+         */
+        std::string_view operator[](std::size_t i) const { return strings[indices[i]]; }
+
+        /*
+         * The code of string i, its index in the dictionary. Two strings are equal when their codes are.
+         */
+        [[nodiscard]] std::uint32_t code(std::size_t i) const { return indices[i]; }
+
+        [[nodiscard]] const std::vector<std::uint32_t> &codes() const { return indices; }
+
+        /*
+         * The distinct strings.
+         */
+        [[nodiscard]] const StringTable &dictionary() const { return strings; }
+
+        /*
+         * The code of a string, to filter on: nothing when no element is equal to it. Searches the dictionary.
+         */
+        [[nodiscard]] std::optional<std::uint32_t> find(std::string_view string) const {
+            for (std::size_t i = 0; i < strings.size(); ++i) {
+                if (strings[i] == string) return static_cast<std::uint32_t>(i);
+            }
+            return std::nullopt;
+        }
+
+        /*
+         * Removes every string but keeps the memory for the next deserialization.
+         */
+        void clear() {
+            strings.clear();
+            indices.clear();
+        }
+
+        [[nodiscard]] std::size_t payload_size() const { return DictionaryLayout::size(indices.size(), strings); }
+
+        std::byte *encode_payload(std::byte *out) const { return DictionaryLayout::encode(strings, indices, out); }
+    };
+}
+
+template<typename Container>
+struct type_tag<CES::DictionaryStrings<Container>> {
+    static_assert(type_tag_v<Container> == STRING_ARRAY, "Only string arrays have a dictionary encoding");
+    static constexpr type value = DICTIONARY_STRING_ARRAY;
+};
+
+template<> struct type_tag<CES::CodedStrings> { static constexpr type value = DICTIONARY_STRING_ARRAY; };
+
+#endif //BINARY_DATA_PROCESSING_STRINGDICTIONARY_HPP
@@ -0,0 +1,115 @@
+#ifndef BINARY_DATA_PROCESSING_STRINGTABLE_HPP
+#define BINARY_DATA_PROCESSING_STRINGTABLE_HPP
+
+/**
+ * @file StringTable.hpp
+ * @brief Contains the StringTable class, an array of strings stored in a single arena.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details The characters of every string are stored back to back in one buffer and the strings are described by
+ * offsets into it. Deserializing a STRING_ARRAY into a StringTable costs two growing buffers instead of one
+ * allocation per string, and a table that is cleared and reused does not allocate at all.
+ * @copyright CES Public License
+ */
+
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+#include <vector>
+#include "ByteBuffer.hpp"
+#include "TypeDefinitions.hpp"
+
+namespace CES {
+    class StringTable {
+        ByteBuffer characters;
+        std::vector<std::size_t> offsets{0}; // string i spans [offsets[i], offsets[i + 1]).
+
+    public:
+
+        class iterator {
+            const StringTable *table = nullptr;
+            std::size_t index = 0;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = std::string_view;
+
+            iterator() = default;
+
+            iterator(const StringTable *table, std::size_t index) : table(table), index(index) {}
+
+            std::string_view operator*() const { return (*table)[index]; }
+
+            iterator &operator++() {
+                ++index;
+                return *this;
+            }
+
+            iterator operator++(int) {
+                iterator previous = *this;
+                ++index;
+                return previous;
+            }
+
+            bool operator==(const iterator &other) const { return index == other.index; }
+        };
+
+        StringTable() = default;
+
+        /*
+         * Number of strings in the table.
+         */
+        [[nodiscard]] std::size_t size() const { return offsets.size() - 1; }
+
+        [[nodiscard]] bool empty() const { return size() == 0; }
+
+        /*
+         * A view of string i. It is invalidated when a string is added.
+         */
+        std::string_view operator[](std::size_t i) const {
+            return {reinterpret_cast<const char *>(characters.data()) + offsets[i], offsets[i + 1] - offsets[i]};
+        }
+
+        [[nodiscard]] iterator begin() const { return {this, 0}; }
+        [[nodiscard]] iterator end() const { return {this, size()}; }
+
+        /*
+         * Reserves room for count strings holding bytes characters in total.
+         */
+        void reserve(std::size_t count, std::size_t bytes) {
+            offsets.reserve(count + 1);
+            characters.reserve(bytes);
+        }
+
+        /*
+         * Adds a string of length characters and returns the memory the caller fills them into.
+         * The pointer is valid until the next string is added.
+         */
+        char *append(std::size_t length) {
+            char *out = reinterpret_cast<char *>(characters.grow(length));
+            offsets.push_back(characters.size());
+            return out;
+        }
+
+        void push_back(std::string_view string) {
+            char *out = append(string.size());
+            if (!string.empty()) std::memcpy(out, string.data(), string.size());
+        }
+
+        /*
+         * Removes every string but keeps the memory for the next deserialization.
+         */
+        void clear() {
+            characters.clear();
+            offsets.resize(1);
+        }
+    };
+}
+
+template<> struct type_tag<CES::StringTable> { static constexpr type value = STRING_ARRAY; };
+
+#endif //BINARY_DATA_PROCESSING_STRINGTABLE_HPP
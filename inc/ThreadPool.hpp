@@ -0,0 +1,131 @@
+#ifndef BINARY_DATA_PROCESSING_THREADPOOL_HPP
+#define BINARY_DATA_PROCESSING_THREADPOOL_HPP
+
+/**
+ * @file ThreadPool.hpp
+ * @brief Contains the ThreadPool class that runs the chunks of a large encode or decode on several threads.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details The threads are started once and wait for work. run() hands out task indices from an atomic counter, so
+ * a thread that finishes its chunk early takes the next one, and the calling thread works along instead of waiting.
+ * @copyright CES Public License
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace CES {
+    class ThreadPool {
+        std::vector<std::thread> workers;
+        std::mutex run_mutex; // one run at a time.
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+        std::function<void(std::size_t)> task;
+        std::size_t task_count = 0;
+        std::atomic<std::size_t> next{0};
+        std::size_t generation = 0;
+        std::size_t busy = 0;
+        bool stopping = false;
+        std::exception_ptr failure;
+
+        /*
+         * Runs tasks until none are left. The first exception stops the remaining tasks.
+         */
+        void drain() {
+            for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < task_count;) {
+                try {
+                    task(i);
+                } catch (...) {
+                    const std::lock_guard<std::mutex> lock(mutex);
+                    if (!failure) failure = std::current_exception();
+                    next.store(task_count, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void work() {
+            std::size_t seen = 0;
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                lock.unlock();
+                drain();
+                lock.lock();
+                if (--busy == 0) done.notify_one();
+            }
+        }
+
+    public:
+
+        /*
+         * Starts the threads.
+         * @param threads the number of threads that work on a run, the calling thread included. 0 for one per
+         * hardware thread.
+         */
+        explicit ThreadPool(unsigned threads = 0) {
+            if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+            workers.reserve(threads - 1);
+            for (unsigned t = 1; t < threads; ++t) workers.emplace_back([this] { work(); });
+        }
+
+        ~ThreadPool() {
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (std::thread &worker: workers) worker.join();
+        }
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        /*
+         * The number of threads that work on a run, the calling thread included.
+         */
+        [[nodiscard]] std::size_t size() const { return workers.size() + 1; }
+
+        /*
+         * Calls f(i) for every i in [0, tasks) on the threads of the pool and returns when all calls are done.
+         * Rethrows the first exception of a task, the tasks that have not started by then are skipped.
+         */
+        template<typename F>
+        void run(std::size_t tasks, F &&f) {
+            if (tasks == 0) return;
+            if (workers.empty() || tasks == 1) {
+                for (std::size_t i = 0; i < tasks; ++i) f(i);
+                return;
+            }
+            const std::lock_guard<std::mutex> running(run_mutex);
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                task = std::ref(f);
+                task_count = tasks;
+                next.store(0, std::memory_order_relaxed);
+                busy = workers.size();
+                failure = nullptr;
+                ++generation;
+            }
+            wake.notify_all();
+            drain();
+
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [&] { return busy == 0; });
+            task = nullptr;
+            if (failure) std::rethrow_exception(std::exchange(failure, nullptr));
+        }
+    };
+}
+#endif //BINARY_DATA_PROCESSING_THREADPOOL_HPP
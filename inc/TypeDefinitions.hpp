@@ -5,6 +5,17 @@
 #ifndef BINARY_DATA_PROCESSING_TYPEDEFINITIONS_HPP
 #define BINARY_DATA_PROCESSING_TYPEDEFINITIONS_HPP
 
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
 enum type{
     INT,
     UNSIGNED_INT,
@@ -36,10 +47,158 @@ enum type{
     CHAR_ARRAY,
     UNSIGNED_CHAR_ARRAY,
     BOOL_ARRAY,
+    PACKED_BOOL_ARRAY, // BOOL_ARRAY with 8 bools per byte.
+    VARINT, // an unsigned integer stored as a LEB128 varint.
+    ZIGZAG_VARINT, // a signed integer, zigzag mapped and stored as a varint.
+    VARINT_ARRAY, // the count and the byte length of the payload as varints, then a varint per unsigned integer.
+    ZIGZAG_VARINT_ARRAY, // the same for signed integers.
+    STRUCT, // a struct with registered fields (see Reflection.hpp).
+    COLUMNS, // an array of structs, stored column by column (see Columns.hpp).
+    DELTA_ARRAY, // integers as bit packed differences to the previous value (see SeriesCoder.hpp).
+    DELTA_OF_DELTA_ARRAY, // integers as bit packed differences of consecutive differences.
+    XOR_FLOAT_ARRAY, // floats or doubles as the bit packed XOR with the previous value.
+    DICTIONARY_STRING_ARRAY, // the distinct strings once, then a code per string (see StringDictionary.hpp).
+    ZONED_ARRAY, // numbers with the minimum and maximum of every block in front of them (see ZoneMap.hpp).
 };
 
+/*
+ * The number of type flags, every flag is below it.
+ */
+inline constexpr std::size_t type_count = ZONED_ARRAY + 1;
+
 enum system_type{
     LE,
     BE
 };
+
+/*
+ * Maps a C++ type to the type enumerator it is serialized with. Resolved at compile time, so the type flag that is
+ * written and the one that is expected when reading are constants. Unsupported types do not compile.
+ */
+template<typename T>
+struct type_tag {
+    static_assert(sizeof(T) == 0, "Type not supported by the BinaryConverter");
+};
+
+template<> struct type_tag<int> { static constexpr type value = INT; };
+template<> struct type_tag<unsigned int> { static constexpr type value = UNSIGNED_INT; };
+template<> struct type_tag<short> { static constexpr type value = SHORT; };
+template<> struct type_tag<unsigned short> { static constexpr type value = UNSIGNED_SHORT; };
+template<> struct type_tag<long> { static constexpr type value = LONG; };
+template<> struct type_tag<unsigned long> { static constexpr type value = UNSIGNED_LONG; };
+template<> struct type_tag<long long> { static constexpr type value = LONG_LONG; };
+template<> struct type_tag<unsigned long long> { static constexpr type value = UNSIGNED_LONG_LONG; };
+template<> struct type_tag<float> { static constexpr type value = FLOAT; };
+template<> struct type_tag<double> { static constexpr type value = DOUBLE; };
+template<> struct type_tag<long double> { static constexpr type value = LONG_DOUBLE; };
+template<> struct type_tag<char> { static constexpr type value = CHAR; };
+template<> struct type_tag<unsigned char> { static constexpr type value = UNSIGNED_CHAR; };
+template<> struct type_tag<bool> { static constexpr type value = BOOL; };
+
+/*
+ * The array types are declared in the same order as the single value types, INT_ARRAY places after INT.
+ */
+template<typename T>
+struct array_type_tag {
+    static_assert(type_tag<std::remove_cv_t<T>>::value < INT_ARRAY, "Only arrays of single values and strings are supported");
+    static constexpr type value = static_cast<type>(type_tag<std::remove_cv_t<T>>::value + INT_ARRAY);
+};
+
+template<typename T, std::size_t N> struct type_tag<T[N]> : array_type_tag<T> {};
+template<typename T, std::size_t N> struct type_tag<std::array<T, N>> : array_type_tag<T> {};
+template<typename T, typename Allocator> struct type_tag<std::vector<T, Allocator>> : array_type_tag<T> {};
+template<typename T, std::size_t Extent> struct type_tag<std::span<T, Extent>> : array_type_tag<T> {};
+
+/*
+ * A bitset is already packed, so it is written as a PACKED_BOOL_ARRAY.
+ */
+template<std::size_t N> struct type_tag<std::bitset<N>> { static constexpr type value = PACKED_BOOL_ARRAY; };
+
+/*
+ * A struct that lists its fields with CES_FIELDS, or has a ces_fields() member returning them as a tuple.
+ */
+template<typename T> requires requires(const T &obj) { obj.ces_fields(); }
+struct type_tag<T> { static constexpr type value = STRUCT; };
+
+/*
+ * Every char string is a STRING, whatever its allocator, and so is a string_view (write only).
+ */
+template<typename Traits, typename Allocator>
+struct type_tag<std::basic_string<char, Traits, Allocator>> { static constexpr type value = STRING; };
+template<typename Traits>
+struct type_tag<std::basic_string_view<char, Traits>> { static constexpr type value = STRING; };
+
+template<typename T>
+inline constexpr type type_tag_v = type_tag<std::remove_cv_t<T>>::value;
+
+/*
+ * The size of one element of the payload of a type: the value itself for single values, one character for STRING
+ * and the element for arrays. STRING_ARRAY, PACKED_BOOL_ARRAY and varint elements have no fixed size, 0 is returned
+ * for them.
+ */
+constexpr std::size_t element_size(type t) {
+    constexpr std::size_t sizes[] = {
+            sizeof(int), sizeof(unsigned int), sizeof(short), sizeof(unsigned short), sizeof(long),
+            sizeof(unsigned long), sizeof(long long), sizeof(unsigned long long), sizeof(float), sizeof(double),
+            sizeof(long double), sizeof(char), sizeof(char), sizeof(unsigned char), sizeof(bool),
+    };
+    if (t == STRING_ARRAY) return 0;
+    const auto index = static_cast<std::size_t>(t >= INT_ARRAY ? t - INT_ARRAY : t);
+    return index < std::size(sizes) ? sizes[index] : 0;
+}
+
+/*
+ * False for a type flag this version does not know, a corrupted one or one written by a newer version.
+ */
+constexpr bool is_known_type(type t) {
+    return static_cast<unsigned>(t) < type_count;
+}
+
+/*
+ * The compact integer types, whose sizes and length prefixes are varints instead of native values.
+ */
+constexpr bool is_varint(type t) {
+    return t >= VARINT && t <= ZIGZAG_VARINT_ARRAY;
+}
+
+/*
+ * The time series encodings, whose payload is a count, the plain array type flag, a byte length and the encoded
+ * series.
+ */
+constexpr bool is_series(type t) {
+    return t >= DELTA_ARRAY && t <= XOR_FLOAT_ARRAY;
+}
+
+/*
+ * The bytes of one zone of a ZONED_ARRAY of the given plain array type: the minimum and the maximum as elements, the
+ * number of elements of the block and a flag byte.
+ */
+constexpr std::size_t zone_size(type plain) {
+    return 2 * element_size(plain) + sizeof(std::uint32_t) + 1;
+}
+
+/*
+ * The number of bytes that follow the length prefix of a string or array of count elements.
+ * Not defined for STRING_ARRAY, whose elements carry their own length prefixes, nor for the varint types.
+ */
+constexpr std::size_t payload_bytes(type t, std::size_t count) {
+    if (t == PACKED_BOOL_ARRAY) return (count + 7) / 8;
+    return count * element_size(t);
+}
+
+/*
+ * The name of a type enumerator, for error messages.
+ */
+constexpr const char *type_name(type t) {
+    constexpr const char *names[] = {
+            "INT", "UNSIGNED INT", "SHORT", "UNSIGNED SHORT", "LONG", "UNSIGNED LONG", "LONG LONG",
+            "UNSIGNED LONG LONG", "FLOAT", "DOUBLE", "LONG DOUBLE", "STRING", "CHAR", "UNSIGNED CHAR", "BOOL",
+            "INT ARRAY", "UNSIGNED INT ARRAY", "SHORT ARRAY", "UNSIGNED SHORT ARRAY", "LONG ARRAY",
+            "UNSIGNED LONG ARRAY", "LONG LONG ARRAY", "UNSIGNED LONG LONG ARRAY", "FLOAT ARRAY", "DOUBLE ARRAY",
+            "LONG DOUBLE ARRAY", "ARRAY OF STRINGS", "CHAR ARRAY", "UNSIGNED CHAR ARRAY", "BOOL ARRAY",
+            "PACKED BOOL ARRAY", "VARINT", "ZIGZAG VARINT", "VARINT ARRAY", "ZIGZAG VARINT ARRAY", "STRUCT", "COLUMNS",
+            "DELTA ARRAY", "DELTA OF DELTA ARRAY", "XOR FLOAT ARRAY", "DICTIONARY STRING ARRAY", "ZONED ARRAY",
+    };
+    return static_cast<std::size_t>(t) < std::size(names) ? names[t] : "UNKNOWN";
+}
 #endif //BINARY_DATA_PROCESSING_TYPEDEFINITIONS_HPP
@@ -0,0 +1,190 @@
+#ifndef BINARY_DATA_PROCESSING_VARINT_HPP
+#define BINARY_DATA_PROCESSING_VARINT_HPP
+
+/**
+ * @file Varint.hpp
+ * @brief Contains the VarintCoder class that encodes integers as LEB128 varints, zigzag mapped when signed.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details A varint stores 7 bits per byte, least significant group first, and sets the high bit of every byte but
+ * the last. Signed values are zigzag mapped first (0, -1, 1, -2 become 0, 1, 2, 3), so small negative numbers stay
+ * short. Varints have no byte order, the same bytes decode on every system. The batch decoder checks 16 bytes at a time
+ * for continuation bits with a single movemask and converts runs of single byte varints 16 at a time, one and two
+ * byte varints have their own branches, longer ones take the generic loop.
+ * @copyright CES Public License
+ */
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include "CpuFeatures.hpp"
+
+namespace CES {
+    class VarintCoder {
+    public:
+
+        VarintCoder() = delete;
+
+        /*
+         * The longest varint, a 64 bit value needs 10 groups of 7 bits.
+         */
+        static constexpr std::size_t max_size = 10;
+
+        /*
+         * Converts a decoded varint to T, zigzag decoding it when T is signed.
+         * Throws when the value does not fit, for example a LONG that is read into an int.
+         */
+        template<typename T>
+        static T narrow(std::uint64_t raw) {
+            if constexpr (std::is_signed_v<T>) {
+                const std::int64_t value = unzigzag(raw);
+                if constexpr (sizeof(T) < sizeof(std::int64_t)) {
+                    if (value < std::numeric_limits<T>::min() || value > std::numeric_limits<T>::max())
+                        throw std::out_of_range("Varint value does not fit the destination type");
+                }
+                return static_cast<T>(value);
+            } else {
+                if constexpr (sizeof(T) < sizeof(std::uint64_t)) {
+                    if (raw > std::numeric_limits<T>::max())
+                        throw std::out_of_range("Varint value does not fit the destination type");
+                }
+                return static_cast<T>(raw);
+            }
+        }
+
+        /*
+         * The unsigned value a T is stored as.
+         */
+        template<typename T>
+        static std::uint64_t widen(T value) {
+            if constexpr (std::is_signed_v<T>) return zigzag(value);
+            else return value;
+        }
+
+        static constexpr std::uint64_t zigzag(std::int64_t value) {
+            return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+        }
+
+        static constexpr std::int64_t unzigzag(std::uint64_t value) {
+            return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+        }
+
+        /*
+         * The number of bytes the varint of value occupies.
+         */
+        static constexpr std::size_t size(std::uint64_t value) {
+            return (static_cast<std::size_t>(std::bit_width(value | 1)) + 6) / 7;
+        }
+
+        /*
+         * Writes one varint.
+         * @return the position after it.
+         */
+        static unsigned char *encode(std::uint64_t value, unsigned char *out) {
+            while (value >= 0x80) {
+                *out++ = static_cast<unsigned char>(value | 0x80);
+                value >>= 7;
+            }
+            *out++ = static_cast<unsigned char>(value);
+            return out;
+        }
+
+        /*
+         * Reads one varint.
+         * @param in the first byte, moved past the varint when it is complete.
+         * @param end the end of the available bytes.
+         * @param value the decoded value.
+         * @return false when the bytes end before the varint does, in is not moved then.
+         */
+        static bool decode(const unsigned char *&in, const unsigned char *end, std::uint64_t &value) {
+            std::uint64_t result = 0;
+            const unsigned char *position = in;
+            for (unsigned shift = 0; position != end; shift += 7) {
+                const unsigned char byte = *position++;
+                if (shift == 63 && byte > 1) throw std::runtime_error("Malformed varint"); // more than 64 bits.
+                result |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                if (byte < 0x80) {
+                    value = result;
+                    in = position;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /*
+         * The number of bytes encode_array writes for count integers.
+         */
+        template<typename T>
+        static std::size_t encoded_size(const T *values, std::size_t count) {
+            std::size_t bytes = 0;
+            for (std::size_t i = 0; i < count; ++i) bytes += size(widen(values[i]));
+            return bytes;
+        }
+
+        /*
+         * Writes count integers as varints, zigzag mapped when T is signed.
+         * @return the position after the last varint.
+         */
+        template<typename T>
+        static unsigned char *encode_array(const T *values, std::size_t count, unsigned char *out) {
+            for (std::size_t i = 0; i < count; ++i) out = encode(widen(values[i]), out);
+            return out;
+        }
+
+        /*
+         * Decodes up to count varints into integers of type T.
+         * @param in the varints.
+         * @param bytes the number of bytes available, it may end in the middle of a varint.
+         * @param out the destination of the integers.
+         * @param count the number of integers wanted.
+         * @param decoded set to the number of integers written to out.
+         * @return the number of bytes consumed. Only complete varints are consumed.
+         */
+        template<typename T>
+        static std::size_t decode_array(const unsigned char *in, std::size_t bytes, T *out, std::size_t count,
+                                        std::size_t &decoded) {
+            static_assert(std::is_integral_v<T> && sizeof(T) >= 2, "Varints decode into short, int, long and long long");
+            const unsigned char *position = in;
+            const unsigned char *end = in + bytes;
+            std::size_t n = 0;
+            bool single = true; // the 16 byte check only pays off inside runs of single byte varints.
+            while (n < count) {
+#ifdef CES_X86
+                if (single && count - n >= 16 && end - position >= 16) {
+                    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(position));
+                    if (_mm_movemask_epi8(block) == 0) { // no continuation bit: 16 single byte varints.
+                        for (std::size_t j = 0; j < 16; ++j) {
+                            const unsigned char byte = position[j];
+                            if constexpr (std::is_signed_v<T>) out[n + j] = static_cast<T>((byte >> 1) ^ -(byte & 1));
+                            else out[n + j] = static_cast<T>(byte);
+                        }
+                        position += 16;
+                        n += 16;
+                        continue;
+                    }
+                }
+#endif
+                std::uint64_t value;
+                if (position != end && position[0] < 0x80) {
+                    value = position[0];
+                    position += 1;
+                } else if (end - position >= 2 && position[1] < 0x80) {
+                    value = (position[0] & 0x7F) | (std::uint64_t{position[1]} << 7);
+                    position += 2;
+                } else if (!decode(position, end, value)) {
+                    break;
+                }
+                single = value < 0x80;
+                out[n++] = narrow<T>(value);
+            }
+            decoded = n;
+            return static_cast<std::size_t>(position - in);
+        }
+    };
+}
+#endif //BINARY_DATA_PROCESSING_VARINT_HPP
@@ -0,0 +1,336 @@
+#ifndef BINARY_DATA_PROCESSING_ZONEMAP_HPP
+#define BINARY_DATA_PROCESSING_ZONEMAP_HPP
+
+/**
+ * @file ZoneMap.hpp
+ * @brief Contains the ZonedArray class, which scans a ZONED_ARRAY for the values of a range and skips the blocks that
+ * cannot hold any.
+ * @author Rafael Costin Balan / Gheorghe Smoc
+ * @date 2026-10-17
+ * @version 1.0
+ * @details BinaryConverter::serialize(CES::zone_map(prices), ostream) writes a ZONED_ARRAY: the elements of a plain
+ * array, preceded by a zone of every block of 4096 elements with their minimum, maximum, count and whether the block
+ * is free of NaNs (see Encodings.hpp). Deserializing into the plain container reads it like the plain array.
+ *
+ * Opening a ZonedArray reads only the zones. scan(low, high, callback) then reads the blocks whose zone overlaps the
+ * range, from memory or with one seek and one read each from a stream, and leaves the others where they are. A block
+ * that lies inside the range is handed over whole, the elements of the others are compared with AVX2 when the CPU
+ * has it. The more the values are clustered, sorted timestamps or ids for example, the more blocks are skipped.
+ * @copyright CES Public License
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "BinaryConverter.hpp"
+#include "CpuFeatures.hpp"
+
+namespace CES {
+    /*
+     * The statistics of one block. The bounds leave NaNs out, they are NaN when every element is.
+     */
+    template<typename T>
+    struct Zone {
+        T min;
+        T max;
+        std::uint32_t count;
+        bool nan_free;
+    };
+
+    /*
+     * Selects the elements of an array that lie in a closed range. The elements are read with unaligned loads, so an
+     * array in the middle of a serialized buffer is filtered where it is.
+     */
+    class RangeFilter {
+        /*
+         * The element types with an AVX2 comparison: 4 and 8 byte integers, floats and doubles.
+         */
+        template<typename T>
+        static constexpr bool has_avx2_kernel = std::is_floating_point_v<T> || (std::is_integral_v<T> && (sizeof(T) == 4 || sizeof(T) == 8));
+
+#ifdef CES_X86
+        /*
+         * Compares 32 bytes of elements per iteration and calls back for the bits of the match mask. Unsigned integers
+         * are compared as signed ones after flipping their sign bit, AVX2 only has signed comparisons.
+         * @return the number of elements processed, a multiple of the lanes.
+         */
+        template<typename T, typename F>
+        CES_TARGET("avx2")
+        static std::size_t select_avx2(const std::byte *in, std::size_t count, T low, T high, F &callback) {
+            constexpr std::size_t lanes = 32 / sizeof(T);
+            std::size_t i = 0;
+            for (; i + lanes <= count; i += lanes) {
+                const std::byte *lane = in + i * sizeof(T);
+                unsigned bits;
+                if constexpr (std::is_same_v<T, float>) {
+                    const __m256 v = _mm256_loadu_ps(reinterpret_cast<const float *>(lane));
+                    const __m256 inside = _mm256_and_ps(_mm256_cmp_ps(v, _mm256_set1_ps(low), _CMP_GE_OQ),
+                                                        _mm256_cmp_ps(v, _mm256_set1_ps(high), _CMP_LE_OQ));
+                    bits = static_cast<unsigned>(_mm256_movemask_ps(inside));
+                } else if constexpr (std::is_same_v<T, double>) {
+                    const __m256d v = _mm256_loadu_pd(reinterpret_cast<const double *>(lane));
+                    const __m256d inside = _mm256_and_pd(_mm256_cmp_pd(v, _mm256_set1_pd(low), _CMP_GE_OQ),
+                                                         _mm256_cmp_pd(v, _mm256_set1_pd(high), _CMP_LE_OQ));
+                    bits = static_cast<unsigned>(_mm256_movemask_pd(inside));
+                } else if constexpr (sizeof(T) == 4) {
+                    const int flip = std::is_signed_v<T> ? 0 : std::numeric_limits<int>::min();
+                    const __m256i bias = _mm256_set1_epi32(flip);
+                    const __m256i v = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(lane)), bias);
+                    const __m256i below = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(low) ^ flip), v);
+                    const __m256i above = _mm256_cmpgt_epi32(v, _mm256_set1_epi32(static_cast<int>(high) ^ flip));
+                    bits = ~static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_or_si256(below, above)))) & 0xFF;
+                } else {
+                    const long long flip = std::is_signed_v<T> ? 0 : std::numeric_limits<long long>::min();
+                    const __m256i bias = _mm256_set1_epi64x(flip);
+                    const __m256i v = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(lane)), bias);
+                    const __m256i below = _mm256_cmpgt_epi64(_mm256_set1_epi64x(static_cast<long long>(low) ^ flip), v);
+                    const __m256i above = _mm256_cmpgt_epi64(v, _mm256_set1_epi64x(static_cast<long long>(high) ^ flip));
+                    bits = ~static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_or_si256(below, above)))) & 0xF;
+                }
+                for (; bits != 0; bits &= bits - 1) {
+                    const std::size_t j = i + static_cast<std::size_t>(std::countr_zero(bits));
+                    callback(j, load<T>(in, j));
+                }
+            }
+            return i;
+        }
+#endif
+
+    public:
+
+        RangeFilter() = delete;
+
+        /*
+         * Element i of an array that starts at in, which does not have to be aligned for T.
+         */
+        template<typename T>
+        static T load(const std::byte *in, std::size_t i) {
+            T value;
+            std::memcpy(&value, in + i * sizeof(T), sizeof(T));
+            return value;
+        }
+
+        /*
+         * Calls callback(i, value) for every element i of the count elements of type T at in with
+         * low <= value <= high, in order. NaNs never match.
+         */
+        template<typename T, typename F>
+        static void select(const std::byte *in, std::size_t count, T low, T high, F &&callback) {
+            std::size_t i = 0;
+#ifdef CES_X86
+            if constexpr (has_avx2_kernel<T>) {
+                if (CpuFeatures::has_avx2()) i = select_avx2(in, count, low, high, callback);
+            }
+#endif
+            for (; i < count; ++i) {
+                const T value = load<T>(in, i);
+                if (value >= low && value <= high) callback(i, value);
+            }
+        }
+
+        template<typename T, typename F>
+        static void select(const T *in, std::size_t count, T low, T high, F &&callback) {
+            select(reinterpret_cast<const std::byte *>(in), count, low, high, std::forward<F>(callback));
+        }
+    };
+
+    template<typename T>
+    class ZonedArray {
+        static_assert(type_tag_v<T[1]> >= INT_ARRAY && type_tag_v<T[1]> <= DOUBLE_ARRAY, "Only arrays of numbers have a zone map");
+
+        const std::byte *payload = nullptr; // the elements in memory, or
+        std::istream *istream = nullptr; // in a stream, starting at offset.
+        std::streamoff offset = 0;
+        std::size_t count = 0;
+        std::size_t block = 0;
+        std::vector<Zone<T>> zone_list;
+        bool swap = false;
+
+        /*
+         * Reads everything up to the elements: the header, the count, the block size and the zones.
+         */
+        template<typename Source>
+        void read_zones(Source &source) {
+            char header[BinaryConverter::header_size];
+            source.read(header, sizeof(header));
+            if (static_cast<type>(header[1]) != ZONED_ARRAY)
+                throw std::invalid_argument(std::string("Object type does not match serialized data type (") + type_name(ZONED_ARRAY) + ")");
+            swap = static_cast<system_type>(header[0]) != BinaryConverter::detect_system_type();
+            unsigned char plain;
+            source.read(&count, sizeof(count));
+            source.read(&plain, 1);
+            source.read(&block, sizeof(block));
+            if (swap) {
+                count = ByteSwapper::swap(count);
+                block = ByteSwapper::swap(block);
+            }
+            if (plain != type_tag_v<T[1]>)
+                throw std::invalid_argument(std::string("Object type does not match serialized data type (") + type_name(type_tag_v<T[1]>) + ")");
+            if (count > std::numeric_limits<std::size_t>::max() / 16 || (count != 0 && block == 0)) throw std::runtime_error("Corrupted zone map");
+            const std::size_t zones = count == 0 ? 0 : (count - 1) / block + 1;
+            if constexpr (requires { source.remaining(); }) {
+                if (zones > source.remaining() / zone_size(type_tag_v<T[1]>)) throw std::runtime_error("Unexpected end of buffer");
+            }
+            zone_list.clear();
+            std::byte bytes[zone_size(type_tag_v<T[1]>)];
+            for (std::size_t i = 0; i < zones; ++i) {
+                Zone<T> zone;
+                unsigned char nan_free;
+                source.read(bytes, sizeof(bytes));
+                std::memcpy(&zone.min, bytes, sizeof(T));
+                std::memcpy(&zone.max, bytes + sizeof(T), sizeof(T));
+                std::memcpy(&zone.count, bytes + 2 * sizeof(T), sizeof(std::uint32_t));
+                std::memcpy(&nan_free, bytes + 2 * sizeof(T) + sizeof(std::uint32_t), 1);
+                if (swap) {
+                    zone.min = ByteSwapper::swap(zone.min);
+                    zone.max = ByteSwapper::swap(zone.max);
+                    zone.count = ByteSwapper::swap(zone.count);
+                }
+                zone.nan_free = nan_free != 0;
+                if (zone.count != std::min(block, count - i * block)) throw std::runtime_error("Corrupted zone map");
+                zone_list.push_back(zone);
+            }
+        }
+
+        /*
+         * The zone_list[b].count elements of block b, straight from memory unless they need swapping, otherwise
+         * decoded into the buffer. They are not aligned in memory, RangeFilter::load reads them.
+         */
+        const std::byte *block_elements(std::size_t b, std::vector<T> &buffer) const {
+            const std::size_t first = b * block, n = zone_list[b].count;
+            if (payload && !swap) return payload + first * sizeof(T);
+            buffer.resize(n);
+            if (payload) {
+                std::memcpy(buffer.data(), payload + first * sizeof(T), n * sizeof(T));
+            } else {
+                const std::streampos position = istream->tellg();
+                istream->seekg(offset + static_cast<std::streamoff>(first * sizeof(T)));
+                istream->read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(n * sizeof(T)));
+                const bool ok = static_cast<bool>(*istream);
+                istream->clear();
+                istream->seekg(position);
+                if (!ok) throw std::runtime_error("Unexpected end of stream");
+            }
+            if (swap) ByteSwapper::swap_in_place(buffer.data(), n);
+            return reinterpret_cast<const std::byte *>(buffer.data());
+        }
+
+        /*
+         * False when the zone rules out every value of the range. NaN bounds rule out everything.
+         */
+        static bool overlaps(const Zone<T> &zone, T low, T high) { return zone.max >= low && zone.min <= high; }
+
+        static bool inside(const Zone<T> &zone, T low, T high) { return zone.nan_free && low <= zone.min && zone.max <= high; }
+
+    public:
+
+        ZonedArray() = default;
+
+        /*
+         * Opens the array at the start of a buffer and reads its zones.
+         * @param bytes the serialized array. It has to outlive the view.
+         * @param consumed when given, receives the size of the serialized array, the next value starts there.
+         */
+        static ZonedArray from(std::span<const std::byte> bytes, std::size_t *consumed = nullptr) {
+            ByteReader reader(bytes);
+            ZonedArray array;
+            array.read_zones(reader);
+            if (array.count > reader.remaining() / sizeof(T)) throw std::runtime_error("Unexpected end of buffer");
+            array.payload = reader.current();
+            if (consumed) *consumed = bytes.size() - reader.remaining() + array.count * sizeof(T);
+            return array;
+        }
+
+        /*
+         * Opens the array at the position of a seekable stream, reads its zones and moves the stream past it without
+         * reading the elements. The stream has to outlive the view, scanning restores its position.
+         */
+        static ZonedArray from(std::istream &istream) {
+            BinaryConverter::StreamSource source{istream};
+            ZonedArray array;
+            array.read_zones(source);
+            if (!istream) throw std::runtime_error("Unexpected end of stream");
+            if (array.count > static_cast<std::size_t>(std::numeric_limits<std::streamoff>::max()) / sizeof(T))
+                throw std::runtime_error("Corrupted array length");
+            array.istream = &istream;
+            array.offset = istream.tellg();
+            if (array.offset < 0) throw std::invalid_argument("The stream is not seekable");
+            istream.seekg(static_cast<std::streamoff>(array.count * sizeof(T)), std::ios::cur);
+            if (!istream) throw std::runtime_error("Unexpected end of stream");
+            return array;
+        }
+
+        [[nodiscard]] std::size_t size() const { return count; }
+
+        [[nodiscard]] bool empty() const { return count == 0; }
+
+        /*
+         * The number of elements per zone, the last zone may have fewer.
+         */
+        [[nodiscard]] std::size_t block_size() const { return block; }
+
+        [[nodiscard]] const std::vector<Zone<T>> &zones() const { return zone_list; }
+
+        /*
+         * The number of blocks a scan of the range reads, from the zones alone.
+         */
+        [[nodiscard]] std::size_t candidate_blocks(T low, T high) const {
+            return static_cast<std::size_t>(std::count_if(zone_list.begin(), zone_list.end(), [&](const Zone<T> &zone) { return overlaps(zone, low, high); }));
+        }
+
+        /*
+         * Calls callback(index, value) for every element with low <= value <= high, in order. Blocks whose zone
+         * lies outside the range are not read.
+         * @return the number of matching elements.
+         */
+        template<typename F>
+        std::size_t scan(T low, T high, F &&callback) const {
+            std::vector<T> buffer;
+            std::size_t matches = 0;
+            for (std::size_t b = 0; b < zone_list.size(); ++b) {
+                if (!overlaps(zone_list[b], low, high)) continue;
+                const std::size_t first = b * block, n = zone_list[b].count;
+                const std::byte *elements = block_elements(b, buffer);
+                if (inside(zone_list[b], low, high)) {
+                    for (std::size_t i = 0; i < n; ++i) callback(first + i, RangeFilter::load<T>(elements, i));
+                    matches += n;
+                    continue;
+                }
+                RangeFilter::select(elements, n, low, high, [&](std::size_t i, T value) {
+                    callback(first + i, value);
+                    ++matches;
+                });
+            }
+            return matches;
+        }
+
+        /*
+         * The number of elements with low <= value <= high. Blocks that lie inside the range are counted from their
+         * zone and are not read either.
+         */
+        [[nodiscard]] std::size_t count_in(T low, T high) const {
+            std::vector<T> buffer;
+            std::size_t matches = 0;
+            for (std::size_t b = 0; b < zone_list.size(); ++b) {
+                if (!overlaps(zone_list[b], low, high)) continue;
+                if (inside(zone_list[b], low, high)) {
+                    matches += zone_list[b].count;
+                    continue;
+                }
+                RangeFilter::select(block_elements(b, buffer), zone_list[b].count, low, high, [&](std::size_t, T) { ++matches; });
+            }
+            return matches;
+        }
+    };
+}
+#endif //BINARY_DATA_PROCESSING_ZONEMAP_HPP